@@ -22,11 +22,27 @@ BEGINFILE {
       size = substr(FILENAME, RSTART+1, RLENGTH-5)
       break
   default:
+      # saída CSV de benchSistLin (make bench), com o tamanho em cada linha
+      if (FILENAME ~ /BENCH[^\/]*\.csv$/) {
+        type = "BENCH"
+        break
+      }
       print FILENAME" será ignorado" > "/dev/stderr"
       nextfile
   }
 }
 
+# kernel,n,m,reps,min_s,p10_s,mediana_s,p90_s,max_s
+type == "BENCH" {
+  if (FNR > 1) {
+    bench[$2][$1] = $7
+    bench_p10[$2][$1] = $6
+    bench_p90[$2][$1] = $8
+    kernels[$1] = 1
+  }
+  next
+}
+
 FNR > 6 { # pula primeiras 6 linhas de cabeçalho
   switch ($1) {
   case "TABLE":
@@ -54,7 +70,7 @@ FNR > 6 { # pula primeiras 6 linhas de cabeçalho
 ENDFILE { 
   # Calcula media dos tempos
   op = "RDTSC Runtime [s]"
-  if (graph[size][type][table][op]) {
+  if (type != "BENCH" && graph[size][type][table][op]) {
     graph[size][type][table][op] = graph[size][type][table][op] / graph[size][type][table][1]
   }
 }
@@ -181,4 +197,27 @@ END {
 
       printf "%f %f\n", flops_otimiz, flops_normal >> "flops_triang.csv"
   }
+
+  # Mediana e percentis 10 e 90 de benchSistLin, por kernel
+  if (length(kernels)) {
+    PROCINFO["sorted_in"] = "@ind_str_asc"
+    printf "# N" > "tempo_bench.csv"
+    for (k in kernels)
+      printf " %s %s_p10 %s_p90", k, k, k >> "tempo_bench.csv"
+    printf "\n" >> "tempo_bench.csv"
+
+    PROCINFO["sorted_in"] = "@ind_num_asc"
+    for (isize in bench) {
+      printf "%s", isize >> "tempo_bench.csv"
+      PROCINFO["sorted_in"] = "@ind_str_asc"
+      for (k in kernels) {
+        if (k in bench[isize])
+          printf " %s %s %s", bench[isize][k], bench_p10[isize][k], bench_p90[isize][k] >> "tempo_bench.csv"
+        else
+          printf " NaN NaN NaN" >> "tempo_bench.csv"
+      }
+      printf "\n" >> "tempo_bench.csv"
+      PROCINFO["sorted_in"] = "@ind_num_asc"
+    }
+  }
 }
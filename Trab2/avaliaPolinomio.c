@@ -0,0 +1,283 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // getopt()
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "libSistLin.h"
+#include "libES.h"
+#include "libSimd.h"
+
+// valores (polinômios x pontos) avaliados por lote, limita a memória
+#define TAM_LOTE (1 << 22)
+
+
+/*!
+  \brief Lê os pontos de avaliação de um arquivo: "q t_1 ... t_q" em
+         texto, ou o vetor x de um conjunto de dados binário (ES_MAGICA)
+
+  \param arq nome do arquivo
+  \param q recebe o número de pontos
+  \return os pontos. NULL em caso de falha
+*/
+static double *lePontos(const char *arq, unsigned int *q) {
+
+    int fd = open(arq, O_RDONLY);
+    if (fd < 0) {
+        perror(arq);
+        return NULL;
+    }
+
+    t_leitor *in = ES_abreLeitor(fd);
+    double *t = NULL;
+    unsigned int m;
+    int falha = !in;
+
+    if (!falha) {
+        _Bool binario = ES_ehBinario(in);
+        falha = binario ? ES_leCabecalho(in, q, &m) : ES_leUint(in, q);
+        if (!falha && *q) {
+            t = SL_alocaMatrix(1, *q);
+            falha = !t;
+            if (binario && !falha)
+                falha = ES_leDoubles(in, t, *q);
+            for (unsigned int k=0; !binario && !falha && k<*q; ++k)
+                falha = ES_leDouble(in, t+k);
+        }
+    }
+    if (falha || !*q) {
+        fprintf(stderr, "Falha ao ler os pontos de %s\n", arq);
+        SL_liberaMem(t);
+        t = NULL;
+    }
+
+    ES_fechaLeitor(in);
+    close(fd);
+    return t;
+}
+
+/*!
+  \brief Gera q pontos igualmente espaçados em [a, b], a partir de "a:b:q"
+
+  \param esp a especificação
+  \param q recebe o número de pontos
+  \return os pontos. NULL em caso de falha
+*/
+static double *gradePontos(const char *esp, unsigned int *q) {
+
+    double a, b;
+
+    if (sscanf(esp, "%lf:%lf:%u", &a, &b, q) != 3 || !*q) {
+        fprintf(stderr, "Grade inválida: %s (use a:b:q)\n", esp);
+        return NULL;
+    }
+
+    double *t = SL_alocaMatrix(1, *q);
+    if (!t) return NULL;
+    for (unsigned int k=0; k<*q; ++k)
+        t[k] = (*q == 1) ? a : a + (b - a) * k / (*q - 1);
+    return t;
+}
+
+/*!
+  \brief Imprime os valores de cada polinômio, uma linha por polinômio
+
+  \param out escritor de saída
+  \param V valores (m x q)
+  \param binario grava os valores como doubles little-endian em vez de texto
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note Em texto, as linhas são formatadas em paralelo, com buffers
+        próprios de cada thread, e escritas na ordem original
+*/
+static int imprimeValores(t_escritor *out, const double *V, unsigned int m, unsigned int q, _Bool binario) {
+
+    if (binario) return ES_escreveDoubles(out, V, (size_t)m*q);
+
+    int falha = 0;
+
+    #pragma omp parallel reduction(|:falha)
+    {
+        char *buf = malloc((size_t)q*ES_TAM_DBL + 3);
+        if (!buf) falha = 1;
+
+        #pragma omp for ordered schedule(static,1)
+        for (unsigned int r=0; r<m; ++r) {
+            size_t len = 0;
+
+            if (!falha)
+                len = ES_formataVetor(buf, V + (size_t)q*r, q);
+
+            #pragma omp ordered
+            if (len && ES_escreve(out, buf, len))
+                falha = 1;
+        }
+
+        free(buf);
+    }
+
+    return falha ? -1 : 0;
+}
+
+/*!
+  \brief Avalia e imprime um lote de polinômios
+
+  \param P coeficientes, um polinômio de n termos por linha (m x n)
+  \param t os q pontos
+  \param tempo acumula o tempo de avaliação (ms)
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note na saída binária cada lote é um conjunto de dados (ES_MAGICA) com
+        x = pontos e m linhas de q valores
+*/
+static int avaliaLote(t_escritor *out, const double *P, unsigned int n, unsigned int m,
+                      const double *t, unsigned int q, _Bool binario, double *tempo) {
+
+    double *V = SL_alocaMatrix(m, q);
+    if (!V) return -1;
+
+    double t0 = ES_timestamp();
+    int falha = SL_avaliaLote(P, n, m, t, q, V);
+    *tempo += ES_timestamp() - t0;
+
+    if (!falha && binario && (ES_escreveCabecalho(out, q, m) || ES_escreveDoubles(out, t, q)))
+        falha = 1;
+    if (!falha && imprimeValores(out, V, m, q, binario)) falha = 1;
+
+    SL_liberaMem(V);
+    return falha ? -1 : 0;
+}
+
+int main (int argc, char **argv) {
+
+    t_leitor *in;
+    t_escritor *out;
+    double *t=NULL, *P, tempo=0.0;
+    unsigned int n, m, q=0, lote, qtd;
+    unsigned long long avaliados=0;
+    _Bool binario=0, verbose=0;
+    int opt, ret;
+
+    while (-1 != (opt = getopt(argc,argv,"f:p:t:u:v"))) {
+        switch(opt) {
+        case 'f':
+            if (!strcmp(optarg, "binario")) binario = 1;
+            else if (!strcmp(optarg, "texto")) binario = 0;
+            else {
+                fprintf(stderr, "Formato de saída desconhecido: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'p':
+            SL_liberaMem(t);
+            t = lePontos(optarg, &q);
+            if (!t) return EXIT_FAILURE;
+            break;
+        case 't':
+#ifdef _OPENMP
+            omp_set_num_threads(atoi(optarg));
+#endif
+            break;
+        case 'u':
+            SL_liberaMem(t);
+            t = gradePontos(optarg, &q);
+            if (!t) return EXIT_FAILURE;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s -p <arquivo>|-u <a>:<b>:<q> [-f texto|binario] [-t <threads>] [-v] < polinomios\n"
+              "\tAvalia cada polinômio da saída de geraPolinomio (texto ou binária) em q pontos\n"
+              "\t-p pontos do arquivo: \"q t_1 ... t_q\" em texto ou o x de um conjunto binário\n"
+              "\t-u q pontos igualmente espaçados em [a, b]\n"
+              "\t-f formato da saída: texto (padrão, uma linha de q valores por polinômio) ou\n"
+              "\t   binario (formato de ES_MAGICA, com x = pontos)\n"
+              "\t-t número de threads OpenMP\n"
+              "\t-v imprime em stderr a vazão da avaliação (pontos/s)\n",
+              argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!t) {
+        fputs("Nenhum ponto de avaliação (use -p ou -u)\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    in = ES_entrada();
+    out = ES_abreEscritor(STDOUT_FILENO);
+    if (!in || !out) return EXIT_FAILURE;
+
+    for (;;) {
+        if (ES_ehBinario(in)) {
+            // cabeçalho (n, m) e x da saída binária de geraPolinomio
+            if (ES_leCabecalho(in, &n, &m)) return EXIT_FAILURE;
+            P = SL_alocaMatrix(1, n ? n : 1);
+            if (!P || ES_leDoubles(in, P, n)) return EXIT_FAILURE;
+            SL_liberaMem(P);
+
+            lote = TAM_LOTE / (n > q ? n : q);
+            if (!lote) lote = 1;
+            P = SL_alocaMatrix(lote, n ? n : 1);
+            if (!P) return EXIT_FAILURE;
+
+            for (unsigned int r0=0; r0 < m; r0 += qtd) {
+                qtd = (m-r0 < lote) ? m-r0 : lote;
+                if (ES_leDoubles(in, P, (size_t)qtd*n)) return EXIT_FAILURE;
+                if (avaliaLote(out, P, n, qtd, t, q, binario, &tempo)) return EXIT_FAILURE;
+                avaliados += (unsigned long long)qtd*q;
+            }
+            SL_liberaMem(P);
+            continue;
+        }
+
+        // texto: uma linha por polinômio; linhas consecutivas com o mesmo
+        // número de coeficientes formam um lote
+        ret = ES_tokensLinha(in, &n);
+        if (ret == EOF) break;
+        if (ret || !n) {
+            fputs("Falha de leitura\n", stderr);
+            return EXIT_FAILURE;
+        }
+
+        lote = TAM_LOTE / (n > q ? n : q);
+        if (!lote) lote = 1;
+        P = SL_alocaMatrix(lote, n);
+        if (!P) return EXIT_FAILURE;
+
+        for (qtd=0; qtd < lote; ++qtd) {
+            unsigned int termos;
+            if (qtd && (ES_ehBinario(in) || ES_tokensLinha(in, &termos) || termos != n))
+                break;
+            for (unsigned int j=0; j<n; ++j)
+                if (ES_leDouble(in, P + (size_t)n*qtd + j)) {
+                    fputs("Falha de leitura\n", stderr);
+                    return EXIT_FAILURE;
+                }
+        }
+        if (avaliaLote(out, P, n, qtd, t, q, binario, &tempo)) return EXIT_FAILURE;
+        avaliados += (unsigned long long)qtd*q;
+        SL_liberaMem(P);
+    }
+
+    if (verbose)
+        fprintf(stderr, "# %llu avaliações em %.3f ms: %.4g pontos/s, kernels %s\n",
+                avaliados, tempo, tempo > 0.0 ? avaliados / (tempo / 1000.0) : 0.0,
+                SIMD_nivel());
+
+    if (ES_fechaEscritor(out)) return EXIT_FAILURE;
+    SL_liberaMem(t);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // getopt()
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "libSistLin.h"
+#include "libES.h"
+#include "libSimd.h"
+#include "libBench.h"
+
+
+int main (int argc, char **argv) {
+
+    unsigned int n = 16, m = 256, q = 65536;
+    int reps = 5, threads = 1, opt;
+
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    while (-1 != (opt = getopt(argc,argv,"m:n:q:r:t:"))) {
+        switch(opt) {
+        case 'm':
+            m = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            n = strtoul(optarg, NULL, 10);
+            break;
+        case 'q':
+            q = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            reps = atoi(optarg);
+            break;
+        case 't':
+            threads = atoi(optarg);
+#ifdef _OPENMP
+            omp_set_num_threads(threads);
+#endif
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s [-n <coeficientes>] [-m <polinômios>] [-q <pontos>] [-r <repetições>] [-t <threads>]\n"
+              "\tMede SL_avaliaLote() (Horner vetorizado) e imprime CSV com o menor\n"
+              "\ttempo (ms) e a vazão em pontos/s. SL_SIMD escolhe os kernels\n",
+              argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!m || !q || reps < 1) {
+        fputs("Parâmetros inválidos\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    double *P = SL_alocaMatrix(m, n ? n : 1);
+    double *t = SL_alocaMatrix(1, q);
+    double *V = SL_alocaMatrix(m, q);
+    if (!P || !t || !V) return EXIT_FAILURE;
+
+    for (size_t k=0; k<(size_t)m*n; ++k)
+        P[k] = BENCH_aleatorio() - 0.5;
+    for (unsigned int k=0; k<q; ++k)
+        t[k] = 2.0 * BENCH_aleatorio() - 1.0;
+
+    double melhor = 1e300;
+    for (int r=0; r<reps; ++r) {
+        double tempo = ES_timestamp();
+        if (SL_avaliaLote(P, n, m, t, q, V)) return EXIT_FAILURE;
+        tempo = ES_timestamp() - tempo;
+        if (tempo < melhor) melhor = tempo;
+    }
+
+    printf("kernels,threads,n,m,q,tempo_ms,pontos_s\n");
+    printf("%s,%d,%u,%u,%u,%.3f,%.4g\n", SIMD_nivel(), threads, n, m, q, melhor,
+           (double)m*q / (melhor / 1000.0));
+
+    SL_liberaMem(V);
+    SL_liberaMem(t);
+    SL_liberaMem(P);
+    return EXIT_SUCCESS;
+}
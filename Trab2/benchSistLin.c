@@ -0,0 +1,475 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // getopt()
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <float.h>
+
+#ifndef _NO_LIKWID
+#include <likwid.h>
+#else
+#define LIKWID_MARKER_INIT
+#define LIKWID_MARKER_CLOSE
+#define LIKWID_MARKER_START(a)
+#define LIKWID_MARKER_STOP(a)
+#endif
+
+#include "libSistLin.h"
+#include "libES.h"
+#include "libSimd.h"
+#include "libBench.h"
+
+// tamanhos padrão, os mesmos de perfctr
+#define TAMANHOS "10,32,50,64,100,128,200,256,300,400,512"
+#define MAX_TAMANHOS 64
+// tempo devolvido por executa() quando o kernel não existe para o tamanho
+#define SEM_KERNEL -2.0
+// maior n de PorSistema e Intercalado (muitos sistemas pequenos)
+#define MAX_LOTE 32
+
+// kernels medidos; o nome é também a região LIKWID
+typedef enum {
+    INTERPOLACAO = 0, AJUSTE, AJUSTE_MOMENTOS, AJUSTE_LOTE,
+    TRIANGULARIZA, TRIANGULARIZA_OTIMIZ, TRIANGULARIZA_BLOCOS, TRIANGULARIZA_MISTA,
+    TRIANGULARIZA_FIXA, SUBSTITUICAO, SUBSTITUICAO_MISTA, POR_SISTEMA, INTERCALADO,
+    N_KERNELS
+} t_kernel;
+
+static const char *nomes[N_KERNELS] = {
+    "Interpolacao", "AjusteDeCurvas", "AjusteDeCurvasMomentos", "AjusteDeCurvasLote",
+    "Triangulariza", "TriangularizaOtimiz", "TriangularizaBlocos", "TriangularizaMista",
+    "TriangularizaFixa", "Substituicao", "SubstituicaoMista", "PorSistema", "Intercalado"
+};
+
+// entrada de um tamanho: pontos e linhas, equações normais e seus termos
+// independentes (n x m), montados uma vez fora das medições, e os sistemas
+// de PorSistema e Intercalado
+typedef struct {
+    t_sist *SL;
+    double *Ajc, *B;
+    double *Alote, *Blote; // qtd matrizes n x n quaisquer e seus termos (NULL se n > MAX_LOTE)
+    unsigned int qtd;
+} t_dados;
+
+
+/*!
+  \brief Gera um conjunto de dados como gera_entrada: x crescente em
+         [-1, 1], com x[n-1] = 1, e m linhas de valores em [-20, 20]
+
+  \param escala se não nula, x crescente em (0, escala], com x[n-1] =
+         escala: equações normais mal escaladas
+  \param qtd sistemas de PorSistema e Intercalado, com valores em [-1, 1)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int geraDados(t_dados *d, unsigned int n, unsigned int m, double escala, unsigned int qtd) {
+
+    t_sist *SL = d->SL = SL_aloca(n, m);
+    t_sist *Ajc = SL_aloca(n, n);
+    double *lookup = SL_alocaMatrix(n, n);
+    if (!SL || !Ajc || !lookup) return -1;
+
+    d->B = SL_alocaMatrix(n, m);
+    if (!d->B) return -1;
+
+    for (unsigned int j=0; j<n; ++j)
+        SL->x[j] = escala ? escala * (j+1 - BENCH_aleatorio()) / n
+                          : -1.0 + 2.0 * (j+1) / n - BENCH_aleatorio() / n;
+    SL->x[n-1] = escala ? escala : 1.0;
+    for (size_t k=0; k<(size_t)n*m; ++k)
+        SL->A[k] = 40.0 * BENCH_aleatorio() - 20.0;
+
+    if (SL_ajusteDeCurvas(SL, Ajc, 0, lookup) || SL_ajusteDeCurvas_lote(SL, d->B))
+        return -1;
+
+    // a matriz das equações normais passa a ser dos dados
+    d->Ajc = Ajc->A;
+    Ajc->A = NULL;
+    SL_libera(Ajc);
+    SL_liberaMem(lookup);
+
+    // matrizes quaisquer: o pivoteamento troca linhas em pistas diferentes
+    d->qtd = qtd;
+    d->Alote = d->Blote = NULL;
+    if (n > MAX_LOTE) return 0;
+    d->Alote = SL_alocaMatrix(qtd, n*n);
+    d->Blote = SL_alocaMatrix(qtd, n);
+    if (!d->Alote || !d->Blote) return -1;
+    for (size_t e=0; e<(size_t)qtd*n*n; ++e)
+        d->Alote[e] = 2.0 * BENCH_aleatorio() - 1.0;
+    for (size_t e=0; e<(size_t)qtd*n; ++e)
+        d->Blote[e] = 2.0 * BENCH_aleatorio() - 1.0;
+    return 0;
+}
+
+static void liberaDados(t_dados *d) {
+    SL_liberaMem(d->Blote);
+    SL_liberaMem(d->Alote);
+    SL_liberaMem(d->B);
+    SL_liberaMem(d->Ajc);
+    SL_libera(d->SL);
+}
+
+/*!
+  \brief Confere as soluções X (n x m) de SL_LU_MISTA com as da LU
+         compacta em double, a mesma usada quando o refinamento não converge
+
+  \return 0 se cada coluna difere da referência em no máximo sqrt(eps)
+          (norma infinito relativa) e -1 caso contrário ou em caso de falha
+*/
+static int confereMista(t_dados *d, unsigned int bk, const double *X) {
+
+    const unsigned int n = d->SL->n, m = d->SL->m;
+    double *R = SL_alocaMatrix(n, m);
+    t_sist *S = SL_aloca(n, n);
+    int falha = !S || !R;
+
+    if (!falha) {
+        memcpy(S->A, d->Ajc, (size_t)n*n*sizeof(double));
+        memcpy(R, d->B, (size_t)n*m*sizeof(double));
+        S->metodo = SL_LU_COMPACTA;
+        S->bk = bk;
+        falha = SL_fatoracao(S) || SL_substituicao_lote(S, R, m);
+    }
+
+    // soluções idênticas (inclusive NaN) quando o bloco recorreu à LU em double
+    if (!falha && memcmp(R, X, (size_t)n*m*sizeof(double)))
+        for (unsigned int c=0; c<m && !falha; ++c) {
+            double dif = 0.0, ref = 0.0;
+            for (unsigned int i=0; i<n; ++i) {
+                dif = fmax(dif, fabs(X[(size_t)m*i+c] - R[(size_t)m*i+c]));
+                ref = fmax(ref, fabs(R[(size_t)m*i+c]));
+            }
+            if (!(dif <= sqrt(DBL_EPSILON) * ref)) {
+                fprintf(stderr, "SubstituicaoMista: coluna %u difere da LU em double "
+                                "(%.3g, com n=%u)\n", c, dif / ref, n);
+                falha = 1;
+            }
+        }
+
+    SL_liberaMem(R);
+    if (S) SL_libera(S);
+    return falha ? -1 : 0;
+}
+
+/*!
+  \brief Executa uma vez PorSistema ou Intercalado: resolve os d->qtd
+         sistemas pequenos um por vez, com SL_fatoracao() e
+         SL_substituicao(), ou juntos, um por pista SIMD, com
+         SL_resolve_intercalado()
+
+  \return tempo (ms) da resolução, sem a preparação. SEM_KERNEL se
+          n > MAX_LOTE e negativo em caso de falha, inclusive se as soluções
+          de Intercalado não são idênticas bit a bit às de um por vez
+*/
+static double executaLote(t_kernel k, t_dados *d) {
+
+    const unsigned int n = d->SL->n, qtd = d->qtd;
+    double tempo;
+    int falha = 0;
+
+    if (!d->Alote) return SEM_KERNEL;
+
+    t_sist **S = calloc(qtd, sizeof(t_sist *));
+    double **pol = malloc(qtd * sizeof(double *));
+    double *X = SL_alocaMatrix(qtd, n), *ref = SL_alocaMatrix(1, n);
+    falha = !S || !pol || !X || !ref;
+
+    // preparação, fora da medição: sistemas novos, ainda sem fatores
+    for (unsigned int i=0; i<qtd && !falha; ++i) {
+        S[i] = SL_aloca(n, n);
+        if (!S[i]) {
+            falha = 1;
+            break;
+        }
+        memcpy(S[i]->A, d->Alote + (size_t)n*n*i, (size_t)n*n*sizeof(double));
+        memcpy(S[i]->B, d->Blote + (size_t)n*i, n*sizeof(double));
+        pol[i] = X + (size_t)n*i;
+    }
+
+    tempo = ES_timestamp();
+    LIKWID_MARKER_START(nomes[k]);
+    if (falha)
+        ;
+    else if (k == INTERCALADO)
+        falha = SL_resolve_intercalado(S, qtd, pol);
+    else
+        for (unsigned int i=0; i<qtd && !falha; ++i) {
+            falha = SL_fatoracao(S[i]);
+            SL_substituicao(S[i], pol[i]);
+        }
+    LIKWID_MARKER_STOP(nomes[k]);
+    tempo = ES_timestamp() - tempo;
+
+    // SL_resolve_intercalado() não altera S[i]->B nem guarda os fatores
+    if (k == INTERCALADO)
+        for (unsigned int i=0; i<qtd && !falha; ++i) {
+            falha = SL_fatoracao(S[i]);
+            SL_substituicao(S[i], ref);
+            if (!falha && memcmp(ref, pol[i], n*sizeof(double))) {
+                fprintf(stderr, "Intercalado: sistema %u difere de PorSistema (n=%u)\n", i, n);
+                falha = 1;
+            }
+        }
+
+    for (unsigned int i=0; S && i<qtd; ++i)
+        if (S[i]) SL_libera(S[i]);
+    SL_liberaMem(ref);
+    SL_liberaMem(X);
+    free(pol);
+    free(S);
+    return falha ? -1.0 : tempo;
+}
+
+/*!
+  \brief Executa uma vez o kernel k, sobre cópias novas dos dados
+
+  \param bk tamanho do bloco de SL_triangulariza_blocos()
+  \return tempo (ms) do kernel, sem a preparação. SEM_KERNEL se o kernel
+          não existe para n e negativo em caso de falha
+*/
+static double executa(t_kernel k, t_dados *d, unsigned int bk) {
+
+    const unsigned int n = d->SL->n, m = d->SL->m;
+    double *aux = NULL, tempo;
+    int falha = 0;
+
+    if (k == POR_SISTEMA || k == INTERCALADO)
+        return executaLote(k, d);
+
+    t_sist *S = SL_aloca(n, n);
+    if (!S) return -1.0;
+
+    // preparação, fora da medição
+    switch (k) {
+    case AJUSTE:
+        aux = SL_alocaMatrix(n, n); // lookup de SL_ajusteDeCurvas()
+        break;
+    case AJUSTE_LOTE:
+        aux = SL_alocaMatrix(n, m);
+        break;
+    case SUBSTITUICAO:
+    case SUBSTITUICAO_MISTA:
+        memcpy(S->A, d->Ajc, (size_t)n*n*sizeof(double));
+        aux = SL_alocaMatrix(n, m);
+        if (aux) memcpy(aux, d->B, (size_t)n*m*sizeof(double));
+        if (k == SUBSTITUICAO_MISTA) {
+            S->metodo = SL_LU_MISTA;
+            S->bk = bk;
+        }
+        if (SL_fatoracao(S)) falha = 1;
+        break;
+    default:
+        memcpy(S->A, d->Ajc, (size_t)n*n*sizeof(double));
+        aux = S->A;
+        break;
+    }
+    if (!aux || falha) {
+        SL_libera(S);
+        return -1.0;
+    }
+
+    tempo = ES_timestamp();
+    LIKWID_MARKER_START(nomes[k]);
+    switch (k) {
+    case INTERPOLACAO:
+        falha = SL_interpolacao(d->SL, S, 0);
+        break;
+    case AJUSTE:
+        falha = SL_ajusteDeCurvas(d->SL, S, 0, aux);
+        break;
+    case AJUSTE_MOMENTOS:
+        falha = SL_ajusteDeCurvas_momentos(d->SL, S, 0);
+        break;
+    case AJUSTE_LOTE:
+        falha = SL_ajusteDeCurvas_lote(d->SL, aux);
+        break;
+    case TRIANGULARIZA:
+        falha = SL_triangulariza(S);
+        break;
+    case TRIANGULARIZA_OTIMIZ:
+        falha = SL_triangulariza_otimiz(S);
+        break;
+    case TRIANGULARIZA_BLOCOS:
+        falha = SL_triangulariza_blocos(S, bk);
+        break;
+    case TRIANGULARIZA_MISTA:
+        // 1 (pivô nulo em float) só interrompe a fatoração, não é falha
+        falha = SL_triangulariza_mista(S, bk) < 0;
+        break;
+    case TRIANGULARIZA_FIXA:
+        falha = SL_triangulariza_fixa(S);
+        break;
+    case SUBSTITUICAO:
+    case SUBSTITUICAO_MISTA:
+        falha = SL_substituicao_lote(S, aux, m);
+        break;
+    default:
+        break;
+    }
+    LIKWID_MARKER_STOP(nomes[k]);
+    tempo = ES_timestamp() - tempo;
+
+    // fora da medição: o refinamento só pode aceitar soluções da precisão da LU em double
+    if (k == SUBSTITUICAO_MISTA && !falha && confereMista(d, bk, aux)) falha = 1;
+
+    if (aux != S->A) SL_liberaMem(aux);
+    SL_libera(S);
+    if (k == TRIANGULARIZA_FIXA && falha == 1) return SEM_KERNEL;
+    return falha ? -1.0 : tempo;
+}
+
+static int comparaDouble(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/*!
+  \brief Percentil p (0 a 100) de v ordenado, por interpolação linear
+*/
+static double percentil(const double *v, int qtd, double p) {
+    double pos = p / 100.0 * (qtd - 1);
+    int i = (int) pos;
+    return (i+1 < qtd) ? v[i] + (pos - i) * (v[i+1] - v[i]) : v[qtd-1];
+}
+
+int main (int argc, char **argv) {
+
+    const char *tamanhos = TAMANHOS, *filtro = NULL;
+    unsigned int n[MAX_TAMANHOS], qtdTam = 0, m = 0, bk = SL_BK, qtd = 4096;
+    double escala = 0.0;
+    int reps = 10, aquece = 2, opt;
+    _Bool json = 0, primeiro = 1;
+
+    while (-1 != (opt = getopt(argc,argv,"b:jk:m:n:q:r:w:x:"))) {
+        switch(opt) {
+        case 'b':
+            bk = strtoul(optarg, NULL, 10);
+            if (!bk) bk = SL_BK;
+            break;
+        case 'j':
+            json = 1;
+            break;
+        case 'k':
+            filtro = optarg;
+            break;
+        case 'm':
+            m = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            tamanhos = optarg;
+            break;
+        case 'q':
+            qtd = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            reps = atoi(optarg);
+            break;
+        case 'w':
+            aquece = atoi(optarg);
+            break;
+        case 'x':
+            escala = strtod(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s [-n <n1,n2,...>] [-m <linhas>] [-r <repetições>] [-w <aquecimento>]\n"
+              "          [-k <kernel1,kernel2,...>] [-b <bloco>] [-q <sistemas>] [-x <máximo>] [-j]\n"
+              "\tMede os kernels SL_* e imprime, por kernel e tamanho, o mínimo, os\n"
+              "\tpercentis 10, 50 (mediana) e 90 e o máximo do tempo (s), em CSV\n"
+              "\t(Resultados/plot.awk lê arquivos BENCH*.csv) ou JSON com -j\n"
+              "\t-n tamanhos (padrão: %s)\n"
+              "\t-m linhas de cada conjunto de dados (padrão: n)\n"
+              "\t-w execuções descartadas antes das medidas (padrão: %d)\n"
+              "\t-x pontos em (0, máximo] em vez de [-1, 1]: equações normais mal\n"
+              "\t   escaladas, em que SubstituicaoMista deve recorrer à LU em double\n"
+              "\tSubstituicaoMista confere as soluções com as da LU em double\n"
+              "\t-q sistemas n x n quaisquer resolvidos por PorSistema, um por vez, e por\n"
+              "\t   Intercalado, %d por vetor (padrão: 4096; só até n = %d). A vazão em\n"
+              "\t   sistemas/s é q / tempo; Intercalado confere que as soluções são\n"
+              "\t   idênticas bit a bit\n"
+              "\tTriangularizaFixa só existe para n = 4, 8, 10, 16 e 32, e Substituicao\n"
+              "\tusa os kernels fixos nesses tamanhos; SL_FIXAS=0 os desativa\n"
+              "\t-k apenas os kernels indicados, entre:",
+              argv[0], TAMANHOS, aquece, SIMD_PISTAS, MAX_LOTE);
+            for (int k=0; k<N_KERNELS; ++k)
+                fprintf(stderr, " %s", nomes[k]);
+            fputc('\n', stderr);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (const char *p = tamanhos; *p && qtdTam < MAX_TAMANHOS; ) {
+        char *fim;
+        n[qtdTam] = strtoul(p, &fim, 10);
+        if (fim == p || !n[qtdTam]) break;
+        ++qtdTam;
+        p = (*fim == ',') ? fim+1 : fim;
+    }
+    if (!qtdTam || !qtd || reps < 1 || aquece < 0 || escala < 0.0) {
+        fputs("Parâmetros inválidos\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    double *tempos = malloc(reps * sizeof(double));
+    if (!tempos) return EXIT_FAILURE;
+
+    if (json) printf("[");
+    else printf("kernel,n,m,reps,min_s,p10_s,mediana_s,p90_s,max_s\n");
+
+    LIKWID_MARKER_INIT;
+    for (unsigned int t=0; t<qtdTam; ++t) {
+        t_dados d;
+        unsigned int linhas = m ? m : n[t];
+
+        if (geraDados(&d, n[t], linhas, escala, qtd)) return EXIT_FAILURE;
+
+        for (int k=0; k<N_KERNELS; ++k) {
+            if (filtro) {
+                const char *p = strstr(filtro, nomes[k]);
+                size_t len = strlen(nomes[k]);
+                // nome inteiro, não prefixo de outro (Triangulariza x TriangularizaOtimiz)
+                while (p && ((p != filtro && p[-1] != ',') || (p[len] && p[len] != ',')))
+                    p = strstr(p+1, nomes[k]);
+                if (!p) continue;
+            }
+
+            int r;
+            for (r=-aquece; r<reps; ++r) {
+                double tempo = executa(k, &d, bk);
+                if (tempo == SEM_KERNEL) break;
+                if (tempo < 0.0) {
+                    fprintf(stderr, "Falha em %s com n=%u\n", nomes[k], n[t]);
+                    return EXIT_FAILURE;
+                }
+                if (r >= 0) tempos[r] = tempo / 1000.0;
+            }
+            if (r < reps) continue;
+            qsort(tempos, reps, sizeof(double), comparaDouble);
+
+            printf(json ? "%s\n  {\"kernel\": \"%s\", \"n\": %u, \"m\": %u, \"reps\": %d, "
+                          "\"min_s\": %.9g, \"p10_s\": %.9g, \"mediana_s\": %.9g, "
+                          "\"p90_s\": %.9g, \"max_s\": %.9g}"
+                        : "%s%s,%u,%u,%d,%.9g,%.9g,%.9g,%.9g,%.9g\n",
+                   json ? (primeiro ? "" : ",") : "", nomes[k], n[t], linhas, reps,
+                   tempos[0], percentil(tempos, reps, 10), percentil(tempos, reps, 50),
+                   percentil(tempos, reps, 90), tempos[reps-1]);
+            primeiro = 0;
+            fflush(stdout);
+        }
+
+        liberaDados(&d);
+    }
+    LIKWID_MARKER_CLOSE;
+
+    if (json) printf("\n]\n");
+
+    free(tempos);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // getopt()
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "libSistLin.h"
+#include "libES.h"
+#include "libBench.h"
+
+// número de termos independentes resolvidos em cada repetição
+#define M_BENCH 64
+
+
+/*!
+  \brief Preenche a matriz n x n
+
+  \param A a matriz
+  \param n dimensão
+  \param trocas 1: linhas com módulo crescente, de forma que quase toda
+                etapa do pivoteamento parcial troque linhas; 0: diagonal
+                dominante, sem trocas
+*/
+static void preenche(double *A, unsigned int n, _Bool trocas) {
+    for (unsigned int i=0; i<n; ++i) {
+        for (unsigned int j=0; j<n; ++j)
+            A[(size_t)n*i+j] = trocas ? (1.0 + i) * (0.5 + BENCH_aleatorio()) : BENCH_aleatorio();
+        if (!trocas)
+            A[(size_t)n*i+i] += n;
+    }
+}
+
+/*!
+  \brief Mede fatoração e substituição de uma estratégia
+
+  \param metodo SL_LU (L e U separados), SL_LU_COMPACTA (troca física) ou
+                SL_LU_INDIRETA (permutação indireta)
+  \param A a matriz
+  \param X0 termos independentes n x M_BENCH
+  \param tFat menor tempo de fatoração (ms)
+  \param tSub menor tempo de substituição (ms)
+  \param trocas número de etapas que trocaram linhas (inalterado com
+                SL_LU_INDIRETA, que não registra as trocas)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int mede(t_metodo metodo, const double *A, const double *X0, unsigned int n,
+                unsigned int bk, int reps, double *tFat, double *tSub, unsigned int *trocas) {
+
+    double *X = SL_alocaMatrix(n, M_BENCH);
+    if (!X) return -1;
+
+    *tFat = *tSub = 1e300;
+    for (int r=0; r<reps; ++r) {
+        t_sist *SL = SL_aloca(n, n);
+        if (!SL) return -1;
+        memcpy(SL->A, A, (size_t)n*n*sizeof(double));
+        memcpy(X, X0, (size_t)n*M_BENCH*sizeof(double));
+        SL->metodo = metodo;
+        SL->bk = bk;
+
+        double t = ES_timestamp();
+        if (SL_fatoracao(SL)) return -1;
+        t = ES_timestamp() - t;
+        if (t < *tFat) *tFat = t;
+
+        t = ES_timestamp();
+        if (SL_substituicao_lote(SL, X, M_BENCH)) return -1;
+        t = ES_timestamp() - t;
+        if (t < *tSub) *tSub = t;
+
+        if (!SL->perm) {
+            *trocas = 0;
+            for (unsigned int i=0; i<n; ++i)
+                if (SL->piv ? SL->piv[i] != (int) i : SL->vetTroca[2*i] != SL->vetTroca[2*i+1])
+                    ++*trocas;
+        }
+        SL_libera(SL);
+    }
+
+    SL_liberaMem(X);
+    return 0;
+}
+
+int main (int argc, char **argv) {
+
+    unsigned int n = 1000, bk = 0;
+    int reps = 3, opt;
+
+    while (-1 != (opt = getopt(argc,argv,"b:n:r:"))) {
+        switch(opt) {
+        case 'b':
+            bk = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            n = strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            reps = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s [-n <ordem>] [-r <repetições>] [-b <bloco>]\n"
+              "\tCompara troca física de linhas e permutação indireta na LU, em\n"
+              "\tmatrizes com trocas em quase toda etapa e sem trocas. Imprime CSV\n"
+              "\tcom o menor tempo (ms) de fatoração e de %d substituições\n",
+              argv[0], M_BENCH);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!n || reps < 1) {
+        fputs("Parâmetros inválidos\n", stderr);
+        return EXIT_FAILURE;
+    }
+
+    const struct { t_metodo metodo; const char *nome; } estrategias[] = {
+        { SL_LU, "LU" },
+        { SL_LU_COMPACTA, "compacta" },
+        { SL_LU_INDIRETA, "indireta" },
+    };
+
+    double *A = SL_alocaMatrix(n, n);
+    double *X0 = SL_alocaMatrix(n, M_BENCH);
+    if (!A || !X0) return EXIT_FAILURE;
+    for (size_t k=0; k<(size_t)n*M_BENCH; ++k)
+        X0[k] = BENCH_aleatorio();
+
+    printf("entrada,estrategia,n,bk,trocas,fatoracao_ms,substituicao_ms\n");
+    for (int trocas=1; trocas>=0; --trocas) {
+        unsigned int qtd = 0;
+
+        preenche(A, n, trocas);
+        // a mesma matriz gera os mesmos pivôs em todas as estratégias
+        for (unsigned int e=0; e<sizeof(estrategias)/sizeof(estrategias[0]); ++e) {
+            double tFat, tSub;
+
+            if (mede(estrategias[e].metodo, A, X0, n, bk, reps, &tFat, &tSub, &qtd))
+                return EXIT_FAILURE;
+            printf("%s,%s,%u,%u,%u,%.3f,%.3f\n", trocas ? "trocas" : "diagonal",
+                   estrategias[e].nome, n, bk, qtd, tFat, tSub);
+        }
+    }
+
+    SL_liberaMem(X0);
+    SL_liberaMem(A);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // getopt()
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "libSistLin.h"
+#include "libES.h"
+
+
+/*!
+  \brief Escreve conjunto de dados no formato texto de gera_entrada
+
+  \param f_out arquivo de saída
+  \param SL o conjunto de dados
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int escreveTexto(FILE *f_out, t_sist *SL) {
+
+    fprintf(f_out, "%u %u\n", SL->n, SL->m);
+    for (unsigned int j=0; j<SL->n; ++j)
+        fprintf(f_out, "%.17g ", SL->x[j]);
+    fputc('\n', f_out);
+
+    for (unsigned int i=0; i<SL->m; ++i) {
+        for (unsigned int j=0; j<SL->n; ++j)
+            fprintf(f_out, "%.17g ", SL->A[(size_t)SL->n*i+j]);
+        fputc('\n', f_out);
+    }
+    fputc('\n', f_out);
+
+    return ferror(f_out) ? -1 : 0;
+}
+
+/*!
+  \brief Escreve conjunto de dados no formato binário (ver ES_MAGICA)
+
+  \param out escritor de saída
+  \param SL o conjunto de dados
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int escreveBinario(t_escritor *out, t_sist *SL) {
+
+    if (ES_escreveCabecalho(out, SL->n, SL->m)) return -1;
+    if (ES_escreveDoubles(out, SL->x, SL->n)) return -1;
+    return ES_escreveDoubles(out, SL->A, (size_t)SL->n*SL->m);
+}
+
+int main (int argc, char **argv) {
+
+    t_sist *SL;
+    t_escritor *out=NULL;
+    _Bool binario=1;
+    int opt;
+
+    while (-1 != (opt = getopt(argc,argv,"bt"))) {
+        switch(opt) {
+        case 'b':
+            binario = 1;
+            break;
+        case 't':
+            binario = 0;
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s [-b|-t] < entrada > saida\n"
+              "\t-b converte para o formato binário (padrão)\n"
+              "\t-t converte para o formato texto\n"
+              "\tA entrada pode estar em qualquer um dos dois formatos\n",
+              argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (binario) {
+        out = ES_abreEscritor(STDOUT_FILENO);
+        if (!out) return EXIT_FAILURE;
+    }
+
+    while ((SL = SL_leitura()))
+    {
+        if (binario ? escreveBinario(out, SL) : escreveTexto(stdout, SL)) {
+            perror("Falha de escrita");
+            return EXIT_FAILURE;
+        }
+        SL_libera(SL);
+    }
+
+    if (ES_fechaEscritor(out)) return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
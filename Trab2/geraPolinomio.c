@@ -3,80 +3,990 @@
  * Lucas Müller          | GRR20197160
  */
 
+#define _POSIX_C_SOURCE 200809L // getopt()
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifndef _NO_LIKWID
 #include <likwid.h>
 #else
 #define LIKWID_MARKER_INIT
+#define LIKWID_MARKER_THREADINIT
 #define LIKWID_MARKER_CLOSE
 #define LIKWID_MARKER_START(a)
 #define LIKWID_MARKER_STOP(a)
 #endif
 
 #include "libSistLin.h"
+#include "libES.h"
+#include "libSimd.h"
 
+// número de linhas formatadas por vez em cada thread
+#define BK_SAIDA 64
+// linhas por bloco e número de blocos do anel do modo fluxo (-s)
+#define BK_FLUXO 1024
+#define N_FLUXO 3
+// conjuntos de dados lidos à frente por thread no modo lote (-l 0)
+#define FILA_LOTE 64
+// maior mensagem de -v sobre um conjunto de dados
+#define TAM_MSG 256
 
-int main (int argc, char **argv) {
+// opções que definem o processamento de cada conjunto de dados
+typedef struct {
+    unsigned int bk;
+    _Bool refat, verbose, bp, mom, gemm, binario, chol, qr, compacta, indireta, fluxo, mista;
+} t_opcoes;
+
+
+/*!
+  \brief Copia vetor para a coluna de uma matriz n x m
+
+  \param X a matriz
+  \param v o vetor de tamanho n
+  \param col a coluna de destino
+*/
+static void insereColuna(double *X, double *v, unsigned int n, unsigned int m, unsigned int col) {
+    for (unsigned int i=0; i<n; ++i)
+        X[(size_t)m*i+col] = v[i];
+}
+
+/*!
+  \brief Copia a coluna de uma matriz n x m para um vetor
+
+  \param v o vetor de tamanho n
+  \param X a matriz
+  \param col a coluna de origem
+*/
+static void extraiColuna(double *v, double *X, unsigned int n, unsigned int m, unsigned int col) {
+    for (unsigned int i=0; i<n; ++i)
+        v[i] = X[(size_t)m*i+col];
+}
+
+/*!
+  \brief Imprime os polinômios de interpolação e de ajuste de cada linha
+
+  \param out escritor de saída
+  \param Xint polinômios de interpolação, um por coluna (n x m)
+  \param Xajc polinômios de ajuste de curvas, um por coluna (n x m)
+  \param binario grava os coeficientes como doubles little-endian em vez de texto
+  \return 0 se sucesso e -1 em caso de falha
 
-    t_sist *SL, *Int, *Ajc;
-    double *pol, *lookup;
+  \note As linhas são formatadas em paralelo, em blocos de BK_SAIDA linhas
+        com buffers próprios de cada thread, e escritas na ordem original
+*/
+static int imprimePolinomios(t_escritor *out, double *Xint, double *Xajc, unsigned int n, unsigned int m, _Bool binario) {
 
-    LIKWID_MARKER_INIT;   
-    while (!feof(stdin))
+    int falha = 0;
+
+    #pragma omp parallel reduction(|:falha)
     {
-        SL = SL_leitura();
-        if (!SL) break;
+        double *pol = SL_alocaMatrix(1, n);
+        char *buf = malloc(BK_SAIDA * 2 * ((size_t)n*ES_TAM_DBL + 3));
+        if (!pol || !buf) falha = 1;
+
+        #pragma omp for ordered schedule(static,1)
+        for (unsigned int r0=0; r0<m; r0 += BK_SAIDA) {
+            size_t len = 0;
+            unsigned int fim = (r0+BK_SAIDA < m) ? r0+BK_SAIDA : m;
+
+            if (!falha)
+                for (unsigned int i=r0; i<fim; ++i) {
+                    extraiColuna(pol, Xint, n, m, i);
+                    len += binario ? ES_binarioVetor(buf+len, pol, n)
+                                   : ES_formataVetor(buf+len, pol, n);
+
+                    extraiColuna(pol, Xajc, n, m, i);
+                    len += binario ? ES_binarioVetor(buf+len, pol, n)
+                                   : ES_formataVetor(buf+len, pol, n);
+                }
+
+            #pragma omp ordered
+            if (len && ES_escreve(out, buf, len))
+                falha = 1;
+        }
+
+        free(buf);
+        SL_liberaMem(pol);
+    }
+
+    return falha ? -1 : 0;
+}
+
+/*
+ * Modo fluxo (-s): as linhas de um conjunto de dados passam por um anel de
+ * N_FLUXO blocos de até BK_FLUXO linhas. Uma thread lê (e converte) o
+ * próximo bloco enquanto a principal resolve e imprime o atual, de forma
+ * que a memória usada não depende de m
+ */
+typedef struct {
+    t_sist *SL;                 // conjunto de dados (n, m e formato da entrada)
+    double *slot[N_FLUXO];      // blocos de BK_FLUXO x n valores
+    unsigned int qtd[N_FLUXO];  // linhas em cada bloco
+    unsigned int lidos, usados; // blocos produzidos e consumidos
+    _Bool falha, parar;
+    pthread_mutex_t trava;
+    pthread_cond_t cheio, vazio;
+} t_fluxo;
 
+/*!
+  \brief Thread leitora: preenche os blocos livres do anel, na ordem
+*/
+static void *leFluxo(void *arg) {
+
+    t_fluxo *f = arg;
+    const unsigned int m = f->SL->m;
+    unsigned int r0, s, qtd;
+    _Bool falha;
+
+    for (r0=0; r0 < m; r0 += qtd) {
+        qtd = (m-r0 < BK_FLUXO) ? m-r0 : BK_FLUXO;
+
+        pthread_mutex_lock(&f->trava);
+        while (!f->parar && f->lidos - f->usados == N_FLUXO)
+            pthread_cond_wait(&f->vazio, &f->trava);
+        s = f->lidos % N_FLUXO;
+        falha = f->parar;
+        pthread_mutex_unlock(&f->trava);
+        if (falha) break;
+
+        falha = SL_leituraLinhas(f->SL, f->slot[s], qtd) != 0;
+        // com a entrada mapeada, devolve as páginas já convertidas
+        ES_descarta(ES_entrada());
+
+        pthread_mutex_lock(&f->trava);
+        f->qtd[s] = qtd;
+        if (falha) f->falha = 1;
+        else ++f->lidos;
+        pthread_cond_signal(&f->cheio);
+        pthread_mutex_unlock(&f->trava);
+        if (falha) break;
+    }
+
+    return NULL;
+}
+
+/*!
+  \brief Espera o próximo bloco do anel
+
+  \param f o anel
+  \param qtd número de linhas do bloco
+  \return o bloco. NULL se a leitura falhou
+*/
+static double *proximoBloco(t_fluxo *f, unsigned int *qtd) {
+
+    double *bloco = NULL;
+
+    pthread_mutex_lock(&f->trava);
+    while (!f->falha && f->lidos == f->usados)
+        pthread_cond_wait(&f->cheio, &f->trava);
+    if (f->lidos != f->usados) {
+        bloco = f->slot[f->usados % N_FLUXO];
+        *qtd = f->qtd[f->usados % N_FLUXO];
+    }
+    pthread_mutex_unlock(&f->trava);
+    return bloco;
+}
+
+/*!
+  \brief Devolve o bloco atual do anel à thread leitora
+*/
+static void devolveBloco(t_fluxo *f) {
+    pthread_mutex_lock(&f->trava);
+    ++f->usados;
+    pthread_cond_signal(&f->vazio);
+    pthread_mutex_unlock(&f->trava);
+}
+
+/*!
+  \brief Resolve e imprime um conjunto de dados lido só até o cabeçalho
+         (SL_leituraCabecalho()), um bloco de linhas por vez
+
+  \param out escritor de saída
+  \param SL o conjunto de dados, sem SL->A
+  \param Int sistema da interpolação (NULL se ordem != NULL)
+  \param Ajc sistema do ajuste de curvas, com o método já escolhido
+  \param lookup tabela de potências de SL_ajusteDeCurvas() (NULL com mom ou QR)
+  \param ordem ordem de Leja da interpolação por Björck-Pereyra (NULL: LU)
+  \param mom monta Ajc->A a partir dos momentos
+  \param binario formato da saída
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note Ajc->A é montada e os dois sistemas são fatorados no primeiro
+        bloco; os termos independentes do ajuste vêm sempre do produto de
+        SL_ajusteDeCurvas_lote(), como em -g. A saída é idêntica à do modo
+        normal (com -M, à de -M -g, que soma os termos em outra ordem)
+*/
+static int processaFluxo(t_escritor *out, t_sist *SL, t_sist *Int, t_sist *Ajc, double *lookup,
+                         const int *ordem, _Bool mom, _Bool binario) {
+
+    const unsigned int n = SL->n, bkm = (SL->m < BK_FLUXO) ? SL->m : BK_FLUXO;
+    const _Bool qr = Ajc->metodo == SL_QR;
+    t_fluxo f = { .SL = SL };
+    t_sist bloco = *SL;
+    pthread_t leitor;
+    double *Xint, *Xajc, *A;
+    unsigned int qtd;
+    size_t marca = 0;
+    unsigned long fatoracoes;
+    int falha = 0;
+
+    if (!bkm) return 0;
+
+    Xint = SL_alocaMatrix(n, bkm);
+    Xajc = SL_alocaMatrix(n, bkm);
+    if (!Xint || !Xajc) return -1;
+    for (int s=0; s<N_FLUXO; ++s) {
+        f.slot[s] = SL_alocaMatrix(bkm, n);
+        if (!f.slot[s]) return -1;
+    }
+
+    pthread_mutex_init(&f.trava, NULL);
+    pthread_cond_init(&f.cheio, NULL);
+    pthread_cond_init(&f.vazio, NULL);
+    if (pthread_create(&leitor, NULL, leFluxo, &f)) {
+        fputs("Falha ao criar thread de leitura\n", stderr);
+        return -1;
+    }
+
+    for (unsigned int r0=0; r0 < SL->m && !falha; r0 += qtd) {
+        A = proximoBloco(&f, &qtd);
+        if (!A) {
+            falha = 1;
+            break;
+        }
+        // visão do bloco como um conjunto de dados de qtd linhas
+        bloco.A = A;
+        bloco.m = qtd;
+
+        if (r0 == 0) {
+            if (!ordem) {
+                LIKWID_MARKER_START("Interpolacao");
+                if (SL_interpolacao(&bloco, Int, 0)) falha = 1;
+                LIKWID_MARKER_STOP("Interpolacao");
+            }
+
+            LIKWID_MARKER_START("AjusteDeCurvas");
+            if (qr ? SL_interpolacao(&bloco, Ajc, 0)
+                   : mom ? SL_ajusteDeCurvas_momentos(&bloco, Ajc, 0)
+                         : SL_ajusteDeCurvas(&bloco, Ajc, 0, lookup)) falha = 1;
+            LIKWID_MARKER_STOP("AjusteDeCurvas");
+
+            if (falha || (!ordem && SL_fatoracao(Int)) || SL_fatoracao(Ajc)) {
+                falha = 1;
+                break;
+            }
+            // o que cada bloco aloca da arena a partir daqui é temporário
+            marca = SL_arenaMarca();
+        }
+        fatoracoes = (ordem ? 0 : Int->fatoracoes) + Ajc->fatoracoes;
+
+        if (ordem) {
+            LIKWID_MARKER_START("InterpolacaoBP");
+            #pragma omp parallel reduction(|:falha)
+            {
+                double *pol = SL_alocaMatrix(1, n);
+                if (!pol) falha = 1;
+
+                #pragma omp for schedule(static)
+                for (unsigned int i=0; i<qtd; ++i) {
+                    if (falha || SL_interpolacao_bp(&bloco, ordem, i, pol))
+                        falha = 1;
+                    else
+                        insereColuna(Xint, pol, n, qtd, i);
+                }
+                SL_liberaMem(pol);
+            }
+            LIKWID_MARKER_STOP("InterpolacaoBP");
+        } else {
+            LIKWID_MARKER_START("InterpolacaoLU");
+            for (unsigned int i=0; i<qtd; ++i)
+                insereColuna(Xint, A + (size_t)n*i, n, qtd, i);
+            if (SL_substituicao_lote(Int, Xint, qtd)) falha = 1;
+            LIKWID_MARKER_STOP("InterpolacaoLU");
+        }
+
+        LIKWID_MARKER_START("Substituicao");
+        if (qr) {
+            if (SL_qr_lote(Ajc, A, Xajc, qtd)) falha = 1;
+        } else if (SL_ajusteDeCurvas_lote(&bloco, Xajc) || SL_substituicao_lote(Ajc, Xajc, qtd))
+            falha = 1;
+        LIKWID_MARKER_STOP("Substituicao");
+
+        devolveBloco(&f);
+
+        if (!falha && imprimePolinomios(out, Xint, Xajc, n, qtd, binario))
+            falha = 1;
+        // uma refatoração no bloco (-m sem convergência) vale até o fim do
+        // conjunto: a marca passa para depois dela em vez de devolvê-la
+        if ((ordem ? 0 : Int->fatoracoes) + Ajc->fatoracoes != fatoracoes)
+            marca = SL_arenaMarca();
+        else
+            SL_arenaVolta(marca);
+    }
+
+    // em caso de falha, libera a thread leitora se estiver esperando
+    pthread_mutex_lock(&f.trava);
+    f.parar = 1;
+    pthread_cond_signal(&f.vazio);
+    pthread_mutex_unlock(&f.trava);
+    pthread_join(leitor, NULL);
+
+    pthread_cond_destroy(&f.vazio);
+    pthread_cond_destroy(&f.cheio);
+    pthread_mutex_destroy(&f.trava);
+
+    for (int s=0; s<N_FLUXO; ++s)
+        SL_liberaMem(f.slot[s]);
+    SL_liberaMem(Xajc);
+    SL_liberaMem(Xint);
+    return (falha || f.falha) ? -1 : 0;
+}
+
+/*!
+  \brief Estima a memória SL_* de um conjunto de dados, reservada na arena
+         (SL_arenaPrepara()) antes de qualquer alocação dele
+
+  \param op as opções
+  \param entrada inclui as linhas lidas (SL->A, ou os blocos do modo fluxo)
+  \return tamanho em bytes, com folga para o arredondamento das alocações
+*/
+static size_t memoriaConjunto(unsigned int n, unsigned int m, const t_opcoes *op, _Bool entrada) {
+
+    const size_t linhas = (op->fluxo && m > BK_FLUXO) ? BK_FLUXO : m;
+
+    // Xint e Xajc; Int, Ajc e seus fatores (até L e U, mais o de Cholesky)
+    // e lookup; x, B, vetores de permutação e blocos de termos de
+    // SL_substituicao_lote() e do refinamento de -m
+    size_t dbl = 2*linhas*n + 8*(size_t)n*n + (2*SL_BK_LOTE + 8)*(size_t)n;
+    if (entrada) dbl += (op->fluxo ? N_FLUXO : 1) * linhas*n;
+    // blocos de SL_ajusteDeCurvas_lote()
+    if (op->gemm || op->fluxo) dbl += (size_t)n*SL_BK + SL_BK*SL_BK_GEMM;
+
+    return dbl*sizeof(double) + 3*sizeof(t_sist) + 64*SL_ALINHAMENTO;
+}
+
+/*!
+  \brief Resolve e imprime um conjunto de dados e o libera
+
+  \param out escritor de saída
+  \param SL o conjunto de dados, de SL_leitura() (SL_leituraCabecalho() com -s)
+  \param op as opções
+  \param msg recebe, com -v, os contadores de fatoração e reuso (TAM_MSG bytes)
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note toda alocação é liberada aqui, exceto o que veio de uma arena, que
+        o chamador reinicia depois
+*/
+static int processaConjunto(t_escritor *out, t_sist *SL, const t_opcoes *op, char *msg) {
+
+    t_sist *Int=NULL, *Ajc;
+    double *lookup=NULL, *Xint=NULL, *Xajc=NULL;
+    int *ordem=NULL;
+    const unsigned int bk = op->bk;
+    const _Bool bp = op->bp, mom = op->mom, gemm = op->gemm, chol = op->chol, qr = op->qr,
+                compacta = op->compacta, indireta = op->indireta, mista = op->mista;
+
+    msg[0] = '\0';
+
+    if (bp) {
+        ordem = SL_ordemLeja(SL->x, SL->n);
+        if (!ordem) return -1;
+    } else {
         Int = SL_aloca(SL->n, SL->n);
-        if (!Int) return EXIT_FAILURE;
+        if (!Int) return -1;
 
-        Ajc = SL_aloca(SL->n, SL->n);
-        if (!Ajc) return EXIT_FAILURE;
+        Int->bk = bk;
+        if (compacta) {
+            Int->metodo = SL_LU_COMPACTA;
+            Int->emLugar = 1;
+        }
+        if (indireta) Int->metodo = SL_LU_INDIRETA;
+        if (mista) {
+            Int->metodo = SL_LU_MISTA;
+            Int->emLugar = 0;
+        }
+    }
 
-        pol = SL_alocaMatrix(1, SL->n);
-        if (!pol) return EXIT_FAILURE;
+    Ajc = SL_aloca(SL->n, SL->n);
+    if (!Ajc) return -1;
 
-        // guardar valores de x exp
+    // guardar valores de x exp
+    if (!mom && !qr) {
         lookup = SL_alocaMatrix(SL->n, SL->n);
-        if (!lookup) return EXIT_FAILURE;
+        if (!lookup) return -1;
+    }
+
+    Ajc->bk = bk;
+    if (compacta) {
+        Ajc->metodo = SL_LU_COMPACTA;
+        Ajc->emLugar = 1;
+    }
+    if (indireta) Ajc->metodo = SL_LU_INDIRETA;
+    if (mista) {
+        Ajc->metodo = SL_LU_MISTA;
+        Ajc->emLugar = 0;
+    }
+    if (chol) Ajc->metodo = SL_CHOLESKY;
+    if (qr) Ajc->metodo = SL_QR;
+
+    if (op->binario && (ES_escreveCabecalho(out, SL->n, 2*SL->m) ||
+                        ES_escreveDoubles(out, SL->x, SL->n)))
+        return -1;
 
+    if (op->fluxo) {
+        if (processaFluxo(out, SL, Int, Ajc, lookup, ordem, mom, op->binario))
+            return -1;
+    } else {
+        // termos independentes de todas as linhas, um por coluna
+        Xint = SL_alocaMatrix(SL->n, SL->m);
+        if (!Xint) return -1;
 
-        for (int i=0; i<SL->m; ++i) {
+        Xajc = SL_alocaMatrix(SL->n, SL->m);
+        if (!Xajc) return -1;
+
+        // etapa 1: monta os sistemas e os termos independentes da linha 0
+        if (!bp) {
             LIKWID_MARKER_START("Interpolacao");
-            if (SL_interpolacao(SL, Int, i)) return EXIT_FAILURE;
+            if (SL_interpolacao(SL, Int, 0)) return -1;
             LIKWID_MARKER_STOP("Interpolacao");
-		
-            // separa SL->Int em LU
-            if (SL_triangulariza_otimiz(Int)) return EXIT_FAILURE;
+            insereColuna(Xint, Int->B, SL->n, SL->m, 0);
+        }
 
-            SL_substituicao(Int, pol);
-            SL_printMatrix(stdout, pol, SL->n, 1);
-	    
-            LIKWID_MARKER_START("AjusteDeCurvas");
-            if (SL_ajusteDeCurvas(SL, Ajc, i, lookup)) return EXIT_FAILURE;
-            LIKWID_MARKER_STOP("AjusteDeCurvas");
+        LIKWID_MARKER_START("AjusteDeCurvas");
+        if (qr) {
+            // com -q Ajc->A é a própria matriz de Vandermonde
+            if (SL_interpolacao(SL, Ajc, 0)) return -1;
+        } else if (mom ? SL_ajusteDeCurvas_momentos(SL, Ajc, 0)
+                       : SL_ajusteDeCurvas(SL, Ajc, 0, lookup))
+            return -1;
+        if (!qr) insereColuna(Xajc, Ajc->B, SL->n, SL->m, 0);
+
+        // termos independentes das demais linhas, em paralelo. Com -g e -q
+        // apenas a linha 0 do ajuste é necessária, para montar Ajc->A
+        if (!bp || (!gemm && !qr)) {
+            int falha = 0;
 
-            LIKWID_MARKER_START("TriangularizaOtimiz");
-            if (SL_triangulariza_otimiz(Ajc)) return EXIT_FAILURE;
-	    SL_substituicao(Ajc, pol);
-            LIKWID_MARKER_STOP("TriangularizaOtimiz");
+            #pragma omp parallel reduction(|:falha)
+            {
+                // cópias rasas dos sistemas: A compartilhada (só lida a
+                // partir da linha 1), B própria de cada thread
+                t_sist IntT = bp ? *Ajc : *Int, AjcT = *Ajc;
+                IntT.B = bp ? NULL : SL_alocaMatrix(1, SL->n);
+                AjcT.B = SL_alocaMatrix(1, SL->n);
+                if ((!bp && !IntT.B) || !AjcT.B) falha = 1;
 
-            SL_printMatrix(stdout, pol, SL->n, 1);
+                #pragma omp for schedule(static)
+                for (unsigned int i=1; i<SL->m; ++i) {
+                    if (falha) continue;
+                    if (!bp) {
+                        if (SL_interpolacao(SL, &IntT, i)) falha = 1;
+                        insereColuna(Xint, IntT.B, SL->n, SL->m, i);
+                    }
+                    if (gemm || qr) continue;
+                    if (mom ? SL_ajusteDeCurvas_momentos(SL, &AjcT, i)
+                            : SL_ajusteDeCurvas(SL, &AjcT, i, lookup)) falha = 1;
+                    insereColuna(Xajc, AjcT.B, SL->n, SL->m, i);
+                }
 
+                SL_liberaMem(AjcT.B);
+                SL_liberaMem(IntT.B);
+            }
+            if (falha) return -1;
+        }
+        LIKWID_MARKER_STOP("AjusteDeCurvas");
+
+        if (gemm && !qr) {
+            LIKWID_MARKER_START("AjusteDeCurvasLote");
+            if (SL_ajusteDeCurvas_lote(SL, Xajc)) return -1;
+            LIKWID_MARKER_STOP("AjusteDeCurvasLote");
+        }
+
+        // etapas 2 e 3: fatora cada sistema uma única vez por conjunto de
+        // dados e resolve todas as linhas reaproveitando os fatores
+        if (bp) {
+            int falha = 0;
+
+            LIKWID_MARKER_START("InterpolacaoBP");
+            #pragma omp parallel reduction(|:falha)
+            {
+                double *pol = SL_alocaMatrix(1, SL->n);
+                if (!pol) falha = 1;
+
+                #pragma omp for schedule(static)
+                for (unsigned int i=0; i<SL->m; ++i) {
+                    if (falha || SL_interpolacao_bp(SL, ordem, i, pol))
+                        falha = 1;
+                    else
+                        insereColuna(Xint, pol, SL->n, SL->m, i);
+                }
+                SL_liberaMem(pol);
+            }
+            LIKWID_MARKER_STOP("InterpolacaoBP");
+            if (falha) return -1;
+        } else {
+            LIKWID_MARKER_START("InterpolacaoLU");
+            if (SL_fatoracao(Int)) return -1;
+            if (SL_substituicao_lote(Int, Xint, SL->m)) return -1;
+            LIKWID_MARKER_STOP("InterpolacaoLU");
+        }
+
+        LIKWID_MARKER_START(qr ? "QR" : chol ? "Cholesky" : indireta ? "TriangularizaIndireta" : mista ? "TriangularizaMista" : compacta ? "TriangularizaCompacta" : bk ? "TriangularizaBlocos" : "TriangularizaOtimiz");
+        if (SL_fatoracao(Ajc)) return -1;
+        LIKWID_MARKER_STOP(qr ? "QR" : chol ? "Cholesky" : indireta ? "TriangularizaIndireta" : mista ? "TriangularizaMista" : compacta ? "TriangularizaCompacta" : bk ? "TriangularizaBlocos" : "TriangularizaOtimiz");
+
+        LIKWID_MARKER_START("Substituicao");
+        if (qr) {
+            if (SL_qr_lote(Ajc, SL->A, Xajc, SL->m)) return -1;
+        } else if (SL_substituicao_lote(Ajc, Xajc, SL->m))
+            return -1;
+        LIKWID_MARKER_STOP("Substituicao");
+
+        if (imprimePolinomios(out, Xint, Xajc, SL->n, SL->m, op->binario)) return -1;
+
+        if (op->refat && !compacta) {
             LIKWID_MARKER_START("Triangulariza");
-            if (SL_triangulariza(Ajc)) return EXIT_FAILURE;
+            if (SL_triangulariza(Ajc)) return -1;
             LIKWID_MARKER_STOP("Triangulariza");
         }
+    }
 
-        free(lookup);
-        free(pol);
-        SL_libera(Ajc);
-        SL_libera(Int);
-        SL_libera(SL);
+    if (op->verbose) {
+        int len = 0;
+        if (Int)
+            len = snprintf(msg, TAM_MSG, "# n=%u m=%u: Int %lu fatoração(ões), %lu reuso(s), %lu refinamento(s)\n",
+                           SL->n, SL->m, Int->fatoracoes, Int->reusos, Int->refinamentos);
+        snprintf(msg+len, TAM_MSG-len, "# n=%u m=%u: Ajc %lu fatoração(ões) %s, %lu reuso(s), %lu refinamento(s)\n",
+                 SL->n, SL->m, Ajc->fatoracoes,
+                 Ajc->metodo == SL_QR ? "QR" : Ajc->metodo == SL_CHOLESKY ? "Cholesky" :
+                 Ajc->metodo == SL_LU_COMPACTA ? "LU compacta" :
+                 Ajc->metodo == SL_LU_INDIRETA ? "LU indireta" :
+                 Ajc->metodo == SL_LU_MISTA ? "LU mista" : "LU", Ajc->reusos, Ajc->refinamentos);
+    }
+
+    SL_liberaMem(ordem);
+    SL_liberaMem(Xajc);
+    SL_liberaMem(Xint);
+    SL_liberaMem(lookup);
+    SL_libera(Ajc);
+    if (Int) SL_libera(Int);
+    SL_libera(SL);
+
+    return 0;
+}
+
+/*
+ * Modo lote (-l): a thread principal lê os conjuntos de dados à frente,
+ * até encher uma janela de tarefas, e os distribui em rodízio pelas filas
+ * duplas dos trabalhadores. Cada trabalhador retira do fim da própria fila
+ * e, quando ela se esvazia, rouba do início da fila dos demais; resolve o
+ * conjunto inteiro sozinho (uma thread OpenMP), com sua própria arena, e
+ * formata a saída em memória. A principal emite as saídas na ordem da
+ * entrada, à medida que ficam prontas
+ */
+typedef struct {
+    t_sist *SL;
+    t_escritor *saida;     // saída do conjunto, em memória
+    char msg[TAM_MSG];     // mensagem de -v
+    _Bool pronta, falha;
+} t_tarefa;
+
+typedef struct {
+    t_tarefa **item;       // fila circular de cap tarefas
+    unsigned int ini, qtd, cap;
+    pthread_mutex_t trava;
+} t_deque;
+
+typedef struct {
+    const t_opcoes *op;
+    t_tarefa *tarefas;     // janela: a tarefa de número k fica em tarefas[k % janela]
+    unsigned int janela;
+    t_deque *filas;
+    int nTrab;
+    unsigned int pendentes; // tarefas nas filas
+    _Bool fim;              // a leitura terminou
+    pthread_mutex_t trava;
+    pthread_cond_t trabalho, pronta;
+    size_t picoArena;       // maior arena de um trabalhador (bytes)
+} t_lote;
+
+typedef struct {
+    t_lote *lote;
+    int id;
+} t_trabalhador;
+
+/*!
+  \brief Retira uma tarefa da fila: do fim (a própria) ou do início (roubo)
+
+  \return a tarefa. NULL se a fila estava vazia
+*/
+static t_tarefa *retiraTarefa(t_lote *lote, t_deque *d, _Bool roubo) {
+
+    t_tarefa *t = NULL;
+
+    pthread_mutex_lock(&d->trava);
+    if (d->qtd) {
+        --d->qtd;
+        if (roubo) {
+            t = d->item[d->ini];
+            d->ini = (d->ini + 1) % d->cap;
+        } else
+            t = d->item[(d->ini + d->qtd) % d->cap];
+
+        pthread_mutex_lock(&lote->trava);
+        --lote->pendentes;
+        pthread_mutex_unlock(&lote->trava);
+    }
+    pthread_mutex_unlock(&d->trava);
+    return t;
+}
+
+/*!
+  \brief Coloca uma tarefa no fim de uma fila e acorda um trabalhador
+*/
+static void insereTarefa(t_lote *lote, t_deque *d, t_tarefa *t) {
+
+    pthread_mutex_lock(&d->trava);
+    d->item[(d->ini + d->qtd) % d->cap] = t;
+    ++d->qtd;
+
+    pthread_mutex_lock(&lote->trava);
+    ++lote->pendentes;
+    pthread_cond_signal(&lote->trabalho);
+    pthread_mutex_unlock(&lote->trava);
+    pthread_mutex_unlock(&d->trava);
+}
+
+/*!
+  \brief Trabalhador do modo lote: resolve tarefas até o fim da leitura
+*/
+static void *trabalhaLote(void *arg) {
+
+    t_trabalhador *eu = arg;
+    t_lote *lote = eu->lote;
+    t_arena *arena = SL_arenaCria(0);
+    t_tarefa *t;
+
+    LIKWID_MARKER_THREADINIT;
+#ifdef _OPENMP
+    // o paralelismo está nos conjuntos de dados, não dentro de cada um
+    omp_set_num_threads(1);
+#endif
+    SL_arenaAtiva(arena);
+
+    for (;;) {
+        t = retiraTarefa(lote, &lote->filas[eu->id], 0);
+        for (int k=1; !t && k<lote->nTrab; ++k)
+            t = retiraTarefa(lote, &lote->filas[(eu->id + k) % lote->nTrab], 1);
+
+        if (!t) {
+            pthread_mutex_lock(&lote->trava);
+            while (!lote->pendentes && !lote->fim)
+                pthread_cond_wait(&lote->trabalho, &lote->trava);
+            _Bool acabou = !lote->pendentes && lote->fim;
+            pthread_mutex_unlock(&lote->trava);
+            if (acabou) break;
+            continue;
+        }
+
+        // SL->A já vem do heap, lido pela thread principal
+        t->falha = !arena || SL_arenaPrepara(arena, memoriaConjunto(t->SL->n, t->SL->m, lote->op, 0))
+                          || processaConjunto(t->saida, t->SL, lote->op, t->msg)
+                          || SL_arenaReinicia(arena);
+
+        pthread_mutex_lock(&lote->trava);
+        t->pronta = 1;
+        pthread_cond_signal(&lote->pronta);
+        pthread_mutex_unlock(&lote->trava);
+    }
+
+    pthread_mutex_lock(&lote->trava);
+    if (arena && arena->cap > lote->picoArena) lote->picoArena = arena->cap;
+    pthread_mutex_unlock(&lote->trava);
+    SL_arenaLibera(arena);
+    return NULL;
+}
+
+static _Bool tarefaPronta(t_lote *lote, t_tarefa *t) {
+    pthread_mutex_lock(&lote->trava);
+    _Bool pronta = t->pronta;
+    pthread_mutex_unlock(&lote->trava);
+    return pronta;
+}
+
+/*!
+  \brief Espera a tarefa terminar e emite sua saída
+
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int emiteTarefa(t_escritor *out, t_lote *lote, t_tarefa *t) {
+
+    pthread_mutex_lock(&lote->trava);
+    while (!t->pronta)
+        pthread_cond_wait(&lote->pronta, &lote->trava);
+    pthread_mutex_unlock(&lote->trava);
+
+    t->pronta = 0;
+    if (t->falha || ES_despeja(out, t->saida)) return -1;
+    if (t->msg[0]) fputs(t->msg, stderr);
+    return 0;
+}
+
+/*!
+  \brief Modo lote: resolve todos os conjuntos de dados da entrada com
+         nTrab trabalhadores, mantendo até janela conjuntos lidos à frente
+
+  \param out escritor de saída
+  \param op as opções
+  \param conjuntos recebe o número de conjuntos resolvidos
+  \param picoArena recebe a maior arena de um trabalhador (bytes)
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note a saída é idêntica à do modo normal
+*/
+static int processaLote(t_escritor *out, const t_opcoes *op, int nTrab, unsigned int janela,
+                        unsigned long *conjuntos, size_t *picoArena) {
+
+    t_lote lote = { .op = op, .janela = janela, .nTrab = nTrab };
+    pthread_t *threads = malloc(nTrab * sizeof(pthread_t));
+    t_trabalhador *trab = malloc(nTrab * sizeof(t_trabalhador));
+    unsigned long lidas = 0, emitidas = 0;
+    int criadas = 0, falha = 0;
+    t_sist *SL;
+
+    lote.tarefas = calloc(janela, sizeof(t_tarefa));
+    lote.filas = calloc(nTrab, sizeof(t_deque));
+    if (!threads || !trab || !lote.tarefas || !lote.filas) {
+        perror("Falha ao alocar o modo lote");
+        return -1;
+    }
+    for (unsigned int k=0; k<janela; ++k) {
+        lote.tarefas[k].saida = ES_abreEscritorMem(4096);
+        if (!lote.tarefas[k].saida) return -1;
+    }
+    for (int w=0; w<nTrab; ++w) {
+        // cada fila recebe no máximo a janela inteira
+        lote.filas[w].cap = janela;
+        lote.filas[w].item = malloc(janela * sizeof(t_tarefa *));
+        if (!lote.filas[w].item) {
+            perror("Falha ao alocar o modo lote");
+            return -1;
+        }
+        pthread_mutex_init(&lote.filas[w].trava, NULL);
+    }
+
+    pthread_mutex_init(&lote.trava, NULL);
+    pthread_cond_init(&lote.trabalho, NULL);
+    pthread_cond_init(&lote.pronta, NULL);
+
+    for (; criadas < nTrab; ++criadas) {
+        trab[criadas] = (t_trabalhador) { .lote = &lote, .id = criadas };
+        if (pthread_create(&threads[criadas], NULL, trabalhaLote, &trab[criadas])) {
+            fputs("Falha ao criar thread do modo lote\n", stderr);
+            falha = 1;
+            break;
+        }
+    }
+
+    // lê enquanto houver espaço na janela; cheia, emite a tarefa mais antiga
+    while (!falha) {
+        if (lidas - emitidas == janela)
+            falha = emiteTarefa(out, &lote, &lote.tarefas[emitidas++ % janela]) != 0;
+        if (falha || !(SL = SL_leitura())) break;
+
+        t_tarefa *t = &lote.tarefas[lidas % janela];
+        t->SL = SL;
+        insereTarefa(&lote, &lote.filas[lidas % nTrab], t);
+        ++lidas;
+
+        // emite o que já ficou pronto, sem esperar
+        while (!falha && emitidas < lidas && tarefaPronta(&lote, &lote.tarefas[emitidas % janela]))
+            falha = emiteTarefa(out, &lote, &lote.tarefas[emitidas++ % janela]) != 0;
+    }
+
+    pthread_mutex_lock(&lote.trava);
+    lote.fim = 1;
+    pthread_cond_broadcast(&lote.trabalho);
+    pthread_mutex_unlock(&lote.trava);
+
+    while (!falha && emitidas < lidas)
+        falha = emiteTarefa(out, &lote, &lote.tarefas[emitidas++ % janela]) != 0;
+
+    for (int w=0; w<criadas; ++w)
+        pthread_join(threads[w], NULL);
+
+    pthread_cond_destroy(&lote.pronta);
+    pthread_cond_destroy(&lote.trabalho);
+    pthread_mutex_destroy(&lote.trava);
+    for (int w=0; w<nTrab; ++w) {
+        pthread_mutex_destroy(&lote.filas[w].trava);
+        free(lote.filas[w].item);
+    }
+    for (unsigned int k=0; k<janela; ++k)
+        ES_fechaEscritor(lote.tarefas[k].saida);
+    free(lote.filas);
+    free(lote.tarefas);
+    free(trab);
+    free(threads);
+
+    *conjuntos = emitidas;
+    *picoArena = lote.picoArena;
+    return falha ? -1 : 0;
+}
+
+int main (int argc, char **argv) {
+
+    t_sist *SL;
+    t_escritor *out;
+    t_arena *arena;
+    t_opcoes op = { 0 };
+    char msg[TAM_MSG];
+    unsigned int janela=0;
+    unsigned long conjuntos;
+    size_t picoArena;
+    int opt, nTrab=1;
+    _Bool lote=0;
+
+    while (-1 != (opt = getopt(argc,argv,"b:cf:gil:mMpqrst:vz"))) {
+        switch(opt) {
+        case 'b':
+            op.bk = strtoul(optarg, NULL, 10);
+            if (!op.bk) op.bk = SL_BK;
+            break;
+        case 'c':
+            op.chol = 1;
+            break;
+        case 'f':
+            if (!strcmp(optarg, "binario")) op.binario = 1;
+            else if (!strcmp(optarg, "texto")) op.binario = 0;
+            else {
+                fprintf(stderr, "Formato de saída desconhecido: %s\n", optarg);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'g':
+            op.gemm = 1;
+            break;
+        case 'i':
+            op.indireta = 1;
+            break;
+        case 'l':
+            lote = 1;
+            janela = strtoul(optarg, NULL, 10);
+            break;
+        case 'm':
+            op.mista = 1;
+            break;
+        case 'M':
+            op.mom = 1;
+            break;
+        case 'p':
+            op.bp = 1;
+            break;
+        case 'q':
+            op.qr = 1;
+            break;
+        case 'r':
+            op.refat = 1;
+            break;
+        case 's':
+            op.fluxo = 1;
+            break;
+        case 't':
+#ifdef _OPENMP
+            omp_set_num_threads(atoi(optarg));
+#endif
+            break;
+        case 'v':
+            op.verbose = 1;
+            break;
+        case 'z':
+            op.compacta = 1;
+            break;
+        default:
+            fprintf(stderr,
+              "Uso: %s [-b <bloco>|-c|-f texto|binario|-g|-i|-l <conjuntos>|-m|-M|-p|-q|-r|-s|-t <threads>|-v|-z]\n"
+              "\t-b LU por blocos com o tamanho de bloco especificado (0: %d)\n"
+              "\t-c ajuste de curvas por Cholesky (LU se a matriz não for definida positiva)\n"
+              "\t-f formato da saída: texto (padrão) ou binario (formato de ES_MAGICA, com\n"
+              "\t   2m linhas intercalando interpolação e ajuste de curvas)\n"
+              "\t-g termos independentes do ajuste de todas as linhas em um único produto de matrizes\n"
+              "\t-i LU compacta com permutação indireta: o pivoteamento não move linhas\n"
+              "\t-l modo lote: lê até o número indicado de conjuntos de dados à frente (0: %d por\n"
+              "\t   thread) e os resolve em paralelo, um por thread, com saída na ordem da\n"
+              "\t   entrada; para muitos conjuntos pequenos (ignora -s)\n"
+              "\t-m LU em precisão simples com refinamento iterativo em double; usa a LU em\n"
+              "\t   double se o refinamento não convergir (mal condicionamento)\n"
+              "\t-M equações normais a partir dos 2n-1 momentos de x (Hankel)\n"
+              "\t-p interpolação por Björck-Pereyra, sem matriz de Vandermonde\n"
+              "\t-q ajuste de curvas por QR de Householder sobre a matriz de Vandermonde, sem\n"
+              "\t   equações normais (ignora -c, -g e -M)\n"
+              "\t-r refatora com SL_triangulariza() para comparação (região Triangulariza)\n"
+              "\t-s modo fluxo: lê as linhas em blocos de %d, em paralelo com o cálculo,\n"
+              "\t   com memória limitada independente de m (ignora -g e -r)\n"
+              "\t-t número de threads OpenMP (com -l, de trabalhadores)\n"
+              "\t-v imprime em stderr os contadores de fatoração e reuso e a vazão da leitura\n"
+              "\t-z LU compacta: L e U sobrescrevem A, com vetor de permutação de n inteiros (ignora -r)\n",
+              argv[0], SL_BK, FILA_LOTE, BK_FLUXO);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    out = ES_abreEscritor(STDOUT_FILENO);
+    if (!out) return EXIT_FAILURE;
+
+    LIKWID_MARKER_INIT;
+    if (lote) {
+        op.fluxo = 0;
+#ifdef _OPENMP
+        nTrab = omp_get_max_threads();
+#endif
+        if (!janela) janela = FILA_LOTE * nTrab;
+
+        if (processaLote(out, &op, nTrab, janela, &conjuntos, &picoArena))
+            return EXIT_FAILURE;
+        if (op.verbose)
+            fprintf(stderr, "# lote: %lu conjunto(s), %d trabalhador(es), janela %u, arena %zu KB, kernels %s\n",
+                    conjuntos, nTrab, janela, picoArena / 1024, SIMD_nivel());
+    } else {
+        // toda alocação SL_* de um conjunto de dados, exceto o cabeçalho, vem
+        // da arena, reservada a partir de n e m e liberada de uma vez ao final
+        arena = SL_arenaCria(0);
+        if (!arena) return EXIT_FAILURE;
+
+        while ((SL = SL_leituraCabecalho()))
+        {
+            if (SL_arenaPrepara(arena, memoriaConjunto(SL->n, SL->m, &op, 1)))
+                return EXIT_FAILURE;
+            SL_arenaAtiva(arena);
+
+            if (!op.fluxo && SL_leituraMatriz(SL)) {
+                SL_libera(SL);
+                break;
+            }
+            if (processaConjunto(out, SL, &op, msg)) return EXIT_FAILURE;
+            fputs(msg, stderr);
+
+            SL_arenaAtiva(NULL);
+            if (SL_arenaReinicia(arena)) return EXIT_FAILURE;
+        }
+
+        if (op.verbose)
+            fprintf(stderr, "# arena: %zu KB, kernels %s\n", arena->cap / 1024, SIMD_nivel());
+        SL_arenaLibera(arena);
     }
     LIKWID_MARKER_CLOSE;
 
+    if (ES_fechaEscritor(out)) return EXIT_FAILURE;
+
+    if (op.verbose && ES_entrada())
+        fprintf(stderr, "# leitura: %.2f MB/s\n", ES_vazao(ES_entrada()));
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,23 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#include <stdint.h>
+
+#include "libBench.h"
+
+
+static uint64_t semente = 88172645463325252ULL;
+
+/*!
+  \brief Gerador xorshift64, reprodutível entre execuções
+
+  \return valor em [0, 1)
+*/
+double BENCH_aleatorio(void) {
+    semente ^= semente << 13;
+    semente ^= semente >> 7;
+    semente ^= semente << 17;
+    return (semente >> 11) * 0x1.0p-53;
+}
@@ -0,0 +1,17 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#ifndef __LIBBENCH__
+#define __LIBBENCH__
+
+/*
+ * Apoio comum aos programas de medição (bench*): dados pseudoaleatórios
+ * reprodutíveis entre execuções e entre os programas
+ */
+
+// próximo valor do gerador xorshift64, em [0, 1)
+double BENCH_aleatorio(void);
+
+#endif // __LIBBENCH__
@@ -0,0 +1,853 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#define _POSIX_C_SOURCE 200809L // mmap(), posix_madvise(), clock_gettime()
+#define _DEFAULT_SOURCE         // madvise()
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "libES.h"
+
+
+// potências de 10 exatamente representáveis em double
+static const double pot10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define EH_ESPACO(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+#define EH_DIGITO(c) ((c) >= '0' && (c) <= '9')
+
+/*!
+  \brief Retorna tempo em milisegundos
+
+  \return o tempo atual
+*/
+double ES_timestamp(void)
+{
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return((double)(tp.tv_sec*1000.0 + tp.tv_nsec/1000000.0));
+}
+
+/*!
+  \brief Cria leitor em bloco para o descritor fd
+  \note se fd é um arquivo regular, ele é mapeado inteiro em memória
+
+  \param fd descritor de arquivo já aberto
+  \return ponteiro para t_leitor. NULL se houve erro de alocação
+*/
+t_leitor *ES_abreLeitor(int fd) {
+
+  t_leitor *in = calloc(1, sizeof(t_leitor));
+  if (!in) return NULL;
+  in->fd = fd;
+
+  struct stat st;
+  if (!fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0) {
+      off_t ini = lseek(fd, 0, SEEK_CUR);
+      void *mapa = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapa != MAP_FAILED) {
+          posix_madvise(mapa, st.st_size, POSIX_MADV_SEQUENTIAL);
+          in->buf = mapa;
+          in->pos = (ini > 0) ? ini : 0;
+          in->tam = in->cap = st.st_size;
+          in->bytes = st.st_size;
+          in->mapeado = in->fim = 1;
+          return in;
+      }
+  }
+
+  in->buf = malloc(ES_TAM_BUFFER);
+  if (!in->buf) {
+      perror("Falha ao alocar buffer de leitura");
+      free(in);
+      return NULL;
+  }
+  in->cap = ES_TAM_BUFFER;
+
+  return in;
+}
+
+/*!
+  \brief Libera recursos alocados por ES_abreLeitor()
+
+  \param in o leitor
+*/
+void ES_fechaLeitor(t_leitor *in) {
+
+  if (!in) return;
+  if (in->mapeado) munmap(in->buf, in->cap);
+  else free(in->buf);
+  free(in);
+}
+
+/*!
+  \brief Devolve ao sistema as páginas da entrada mapeada já consumidas
+  \note sem efeito se a entrada não está mapeada. As páginas são relidas
+        do arquivo se acessadas de novo, então ponteiros obtidos por
+        ES_mapeiaDoubles() continuam válidos. Mantém o RSS limitado ao
+        percorrer arquivos maiores que a memória
+
+  \param in o leitor
+*/
+void ES_descarta(t_leitor *in) {
+
+  if (!in->mapeado) return;
+
+  size_t pagina = sysconf(_SC_PAGESIZE);
+  size_t fim = in->pos & ~(pagina-1);
+
+  if (fim > in->descartado) {
+      madvise(in->buf + in->descartado, fim - in->descartado, MADV_DONTNEED);
+      in->descartado = fim;
+  }
+}
+
+/*!
+  \brief Leitor da entrada padrão, criado na primeira chamada
+
+  \return ponteiro para t_leitor. NULL se houve erro de alocação
+*/
+t_leitor *ES_entrada(void) {
+
+  static t_leitor *entrada = NULL;
+
+  if (!entrada) entrada = ES_abreLeitor(STDIN_FILENO);
+  return entrada;
+}
+
+/*!
+  \brief Move os dados não consumidos para o início e completa o buffer
+
+  \param in o leitor
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int recarrega(t_leitor *in) {
+
+  ssize_t lido;
+
+  if (in->fim) return 0;
+
+  memmove(in->buf, in->buf + in->pos, in->tam - in->pos);
+  in->tam -= in->pos;
+  in->pos = 0;
+
+  while (in->tam < in->cap) {
+      lido = read(in->fd, in->buf + in->tam, in->cap - in->tam);
+      if (lido < 0) {
+          if (errno == EINTR) continue;
+          perror("Falha de leitura");
+          return -1;
+      }
+      if (lido == 0) {
+          in->fim = 1;
+          break;
+      }
+      in->tam += lido;
+      in->bytes += lido;
+  }
+  return 0;
+}
+
+/*!
+  \brief Descarta espaços em branco até o próximo dado
+
+  \param in o leitor
+  \return 0 se sucesso, EOF se não há mais dados e -1 em caso de falha
+*/
+static int pulaEspacos(t_leitor *in) {
+
+  for (;;) {
+      while (in->pos < in->tam && EH_ESPACO(in->buf[in->pos]))
+          ++in->pos;
+      if (in->pos < in->tam) return 0;
+      if (in->fim) return EOF;
+      if (recarrega(in)) return -1;
+  }
+}
+
+/*!
+  \brief Posiciona o leitor no início do próximo token
+
+  \param in o leitor
+  \param tok recebe o início do token
+  \param len recebe o tamanho do token
+  \return 0 se sucesso, EOF se não há mais tokens e -1 em caso de falha
+*/
+static int proximoToken(t_leitor *in, const char **tok, size_t *len) {
+
+  int ret = pulaEspacos(in);
+  if (ret) return ret;
+
+  // garante que um token inteiro esteja no buffer
+  if (in->tam - in->pos < ES_TAM_TOKEN && !in->fim)
+      if (recarrega(in)) return -1;
+
+  size_t fim = in->pos;
+  while (fim < in->tam && !EH_ESPACO(in->buf[fim]) && fim - in->pos < ES_TAM_TOKEN)
+      ++fim;
+  if (fim - in->pos >= ES_TAM_TOKEN) {
+      fputs("Token numérico muito longo\n", stderr);
+      return -1;
+  }
+
+  *tok = in->buf + in->pos;
+  *len = fim - in->pos;
+  in->pos = fim;
+  return 0;
+}
+
+/*!
+  \brief Converte token em double com o mesmo resultado de strtod()
+
+  \param s o token, não terminado por '\0'
+  \param len tamanho do token
+  \param v recebe o valor
+  \return 0 se sucesso e -1 se o token não é um número
+
+  \note Caminho rápido: mantissas de até 19 dígitos são acumuladas em um
+        inteiro e escaladas por uma potência de 10 exata, o que é
+        corretamente arredondado quando mantissa <= 2^53 e |exp| <= 22.
+        Com long double de 64 bits (x87) o caminho cobre as mantissas de
+        17 dígitos comuns na entrada, exceto quando o resultado fica a
+        menos de 1 ulp(long double) de um ponto médio entre dois doubles.
+        Os demais casos usam strtod()
+*/
+static int converteDouble(const char *s, size_t len, double *v) {
+
+  const char *p = s, *e = s + len;
+  uint64_t mant = 0;
+  int dig = 0, exp10 = 0, expo = 0, sinalExp = 1;
+  _Bool neg = 0, algum = 0;
+
+  if (p < e && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+
+  for (; p < e && EH_DIGITO(*p); ++p) {
+      algum = 1;
+      if (!mant && *p == '0') continue;
+      if (dig == 19) goto lento;
+      mant = mant*10 + (*p - '0');
+      ++dig;
+  }
+  if (p < e && *p == '.') {
+      for (++p; p < e && EH_DIGITO(*p); ++p) {
+          algum = 1;
+          if (!mant && *p == '0') {
+              --exp10;
+              continue;
+          }
+          if (dig == 19) goto lento;
+          mant = mant*10 + (*p - '0');
+          ++dig;
+          --exp10;
+      }
+  }
+  if (!algum) goto lento;
+
+  if (p < e && (*p == 'e' || *p == 'E')) {
+      ++p;
+      if (p < e && (*p == '-' || *p == '+')) sinalExp = (*p++ == '-') ? -1 : 1;
+      if (p == e || !EH_DIGITO(*p)) goto lento;
+      for (; p < e && EH_DIGITO(*p); ++p) {
+          if (expo > 10000) goto lento;
+          expo = expo*10 + (*p - '0');
+      }
+      exp10 += sinalExp*expo;
+  }
+  if (p != e) goto lento;
+
+  if (!mant) {
+      *v = neg ? -0.0 : 0.0;
+      return 0;
+  }
+
+  if (mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+      double d = (double) mant;
+      d = (exp10 < 0) ? d / pot10[-exp10] : d * pot10[exp10];
+      *v = neg ? -d : d;
+      return 0;
+  }
+
+#if LDBL_MANT_DIG == 64 && (defined(__x86_64__) || defined(__i386__))
+  if (exp10 >= -27 && exp10 <= 27) {
+      // 10^k = 2^k * 5^k é exato em long double para k <= 27
+      long double r = (long double) mant, p10 = 1.0L;
+      for (int k = (exp10 < 0) ? -exp10 : exp10; k; --k)
+          p10 *= 10.0L;
+      r = (exp10 < 0) ? r / p10 : r * p10;
+
+      uint64_t bits;
+      memcpy(&bits, &r, sizeof(bits));
+      bits &= 0x7FF; // bits abaixo da precisão de double
+      if (bits < 0x3FF || bits > 0x401) {
+          *v = neg ? -(double) r : (double) r;
+          return 0;
+      }
+  }
+#endif
+
+lento:
+  {
+      char tmp[ES_TAM_TOKEN+1];
+      char *fim;
+
+      memcpy(tmp, s, len);
+      tmp[len] = '\0';
+      *v = strtod(tmp, &fim);
+      return (fim == tmp + len && len) ? 0 : -1;
+  }
+}
+
+/*!
+  \brief Lê o próximo inteiro sem sinal
+
+  \param in o leitor
+  \param v recebe o valor
+  \return 0 se sucesso, EOF se não há mais tokens e -1 em caso de falha
+*/
+int ES_leUint(t_leitor *in, unsigned int *v) {
+
+  const char *tok;
+  size_t len;
+  int ret = proximoToken(in, &tok, &len);
+  if (ret) return ret;
+
+  unsigned long valor = 0;
+  for (size_t i=0; i < len; ++i) {
+      if (!EH_DIGITO(tok[i]) || valor > 0xFFFFFFFFUL/10) return -1;
+      valor = valor*10 + (tok[i] - '0');
+  }
+  if (valor > 0xFFFFFFFFUL) return -1;
+
+  *v = valor;
+  return 0;
+}
+
+/*!
+  \brief Lê o próximo double
+
+  \param in o leitor
+  \param v recebe o valor
+  \return 0 se sucesso, EOF se não há mais tokens e -1 em caso de falha
+*/
+int ES_leDouble(t_leitor *in, double *v) {
+
+  const char *tok;
+  size_t len;
+  int ret = proximoToken(in, &tok, &len);
+  if (ret) return ret;
+
+  return converteDouble(tok, len, v);
+}
+
+/*!
+  \brief Conta os tokens da próxima linha não vazia, sem consumi-los
+  \note a linha inteira precisa caber no buffer de leitura
+
+  \param in o leitor
+  \param qtd recebe o número de tokens
+  \return 0 se sucesso, EOF se não há mais tokens e -1 em caso de falha
+*/
+int ES_tokensLinha(t_leitor *in, unsigned int *qtd) {
+
+  int ret = pulaEspacos(in);
+  if (ret) return ret;
+
+  char *nl = memchr(in->buf + in->pos, '\n', in->tam - in->pos);
+  if (!nl && !in->fim) {
+      if (recarrega(in)) return -1;
+      nl = memchr(in->buf + in->pos, '\n', in->tam - in->pos);
+      if (!nl && !in->fim) {
+          fputs("Linha muito longa\n", stderr);
+          return -1;
+      }
+  }
+
+  const char *p = in->buf + in->pos, *fim = nl ? nl : in->buf + in->tam;
+  *qtd = 0;
+  while (p < fim) {
+      while (p < fim && EH_ESPACO(*p)) ++p;
+      if (p == fim) break;
+      ++*qtd;
+      while (p < fim && !EH_ESPACO(*p)) ++p;
+  }
+  return 0;
+}
+
+/*!
+  \brief Vazão de leitura até o momento
+
+  \param in o leitor
+  \return MB/s consumidos em relação a in->tempo
+*/
+double ES_vazao(t_leitor *in) {
+
+  double consumido = in->bytes - (in->tam - in->pos);
+  return in->tempo > 0.0 ? consumido / (in->tempo * 1000.0) : 0.0;
+}
+
+/*!
+  \brief Inverte a ordem dos bytes de cada double em hosts big-endian
+
+  \param v os valores
+  \param qtd quantidade de valores
+*/
+static void ajustaEndian(double *v, size_t qtd) {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  for (size_t i=0; i < qtd; ++i) {
+      uint64_t b;
+      memcpy(&b, v+i, sizeof(b));
+      b = __builtin_bswap64(b);
+      memcpy(v+i, &b, sizeof(b));
+  }
+#else
+  (void) v;
+  (void) qtd;
+#endif
+}
+
+/*!
+  \brief Verifica se o próximo conjunto de dados está no formato binário
+
+  \param in o leitor
+  \return 1 se binário, 0 caso contrário ou no fim da entrada
+*/
+int ES_ehBinario(t_leitor *in) {
+
+  if (pulaEspacos(in)) return 0;
+  if (in->tam - in->pos < sizeof(t_cabecalhoBin) && !in->fim)
+      if (recarrega(in)) return 0;
+
+  return in->tam - in->pos >= sizeof(t_cabecalhoBin)
+         && !memcmp(in->buf + in->pos, ES_MAGICA, 4);
+}
+
+/*!
+  \brief Lê o cabeçalho de um conjunto de dados binário
+
+  \param in o leitor, posicionado por ES_ehBinario()
+  \param n recebe o número de valores tabelados
+  \param m recebe o número de funções tabeladas
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_leCabecalho(t_leitor *in, unsigned int *n, unsigned int *m) {
+
+  t_cabecalhoBin cab;
+
+  if (in->tam - in->pos < sizeof(cab)) return -1;
+  memcpy(&cab, in->buf + in->pos, sizeof(cab));
+  in->pos += sizeof(cab);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  cab.n = __builtin_bswap32(cab.n);
+  cab.m = __builtin_bswap32(cab.m);
+#endif
+
+  if (memcmp(cab.magica, ES_MAGICA, 4)) return -1;
+  *n = cab.n;
+  *m = cab.m;
+  return 0;
+}
+
+/*!
+  \brief Obtém os próximos qtd doubles sem cópia
+
+  \param in o leitor
+  \param qtd quantidade de valores
+  \return ponteiro somente leitura para a entrada mapeada, ou NULL se a
+          entrada não está mapeada, desalinhada ou em host big-endian (use
+          ES_leDoubles() nesses casos)
+*/
+double *ES_mapeiaDoubles(t_leitor *in, size_t qtd) {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return NULL;
+#endif
+  char *p = in->buf + in->pos;
+
+  if (!in->mapeado || (uintptr_t)p % sizeof(double)
+      || (in->tam - in->pos) / sizeof(double) < qtd)
+      return NULL;
+
+  in->pos += qtd * sizeof(double);
+  return (double *) p;
+}
+
+/*!
+  \brief Copia os próximos qtd doubles da entrada binária
+
+  \param in o leitor
+  \param v destino com espaço para qtd valores
+  \param qtd quantidade de valores
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_leDoubles(t_leitor *in, double *v, size_t qtd) {
+
+  char *dest = (char *) v;
+  size_t falta = qtd * sizeof(double), parte;
+
+  while (falta) {
+      if (in->pos == in->tam) {
+          if (in->fim || recarrega(in) || in->pos == in->tam) {
+              fputs("Entrada binária truncada\n", stderr);
+              return -1;
+          }
+      }
+      parte = in->tam - in->pos;
+      if (parte > falta) parte = falta;
+      memcpy(dest, in->buf + in->pos, parte);
+      in->pos += parte;
+      dest += parte;
+      falta -= parte;
+  }
+
+  ajustaEndian(v, qtd);
+  return 0;
+}
+
+/*!
+  \brief Cria escritor com buffer de ES_TAM_BUFFER bytes para o descritor fd
+
+  \param fd descritor de arquivo já aberto
+  \return ponteiro para t_escritor. NULL se houve erro de alocação
+*/
+t_escritor *ES_abreEscritor(int fd) {
+
+  t_escritor *out = calloc(1, sizeof(t_escritor));
+  if (!out) return NULL;
+
+  out->buf = malloc(ES_TAM_BUFFER);
+  if (!out->buf) {
+      perror("Falha ao alocar buffer de escrita");
+      free(out);
+      return NULL;
+  }
+  out->fd = fd;
+  out->cap = ES_TAM_BUFFER;
+
+  return out;
+}
+
+/*!
+  \brief Cria escritor em memória: o buffer cresce em vez de ser esvaziado,
+         até que o conteúdo seja copiado para outro escritor (ES_despeja())
+
+  \param cap capacidade inicial em bytes
+  \return ponteiro para t_escritor. NULL se houve erro de alocação
+*/
+t_escritor *ES_abreEscritorMem(size_t cap) {
+
+  t_escritor *out = calloc(1, sizeof(t_escritor));
+  if (!out) return NULL;
+
+  out->buf = malloc(cap ? cap : 1);
+  if (!out->buf) {
+      perror("Falha ao alocar buffer de escrita");
+      free(out);
+      return NULL;
+  }
+  out->fd = -1;
+  out->cap = cap ? cap : 1;
+
+  return out;
+}
+
+/*!
+  \brief Copia o conteúdo de um escritor em memória para outro e o esvazia
+
+  \param out escritor de destino
+  \param mem escritor em memória (ES_abreEscritorMem())
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_despeja(t_escritor *out, t_escritor *mem) {
+
+  int ret = ES_escreve(out, mem->buf, mem->tam);
+  mem->tam = 0;
+  return ret;
+}
+
+/*!
+  \brief Escreve len bytes diretamente no descritor
+
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int escreveTudo(int fd, const char *dados, size_t len) {
+
+  ssize_t escrito;
+
+  while (len) {
+      escrito = write(fd, dados, len);
+      if (escrito < 0) {
+          if (errno == EINTR) continue;
+          perror("Falha de escrita");
+          return -1;
+      }
+      dados += escrito;
+      len -= escrito;
+  }
+  return 0;
+}
+
+/*!
+  \brief Escreve o conteúdo do buffer no descritor
+
+  \param out o escritor
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_esvazia(t_escritor *out) {
+
+  if (out->fd < 0) return 0; // em memória: o conteúdo fica até ES_despeja()
+  if (escreveTudo(out->fd, out->buf, out->tam)) return -1;
+  out->tam = 0;
+  return 0;
+}
+
+/*!
+  \brief Esvazia e libera recursos alocados por ES_abreEscritor()
+
+  \param out o escritor
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_fechaEscritor(t_escritor *out) {
+
+  if (!out) return 0;
+  int ret = ES_esvazia(out);
+  free(out->buf);
+  free(out);
+  return ret;
+}
+
+/*!
+  \brief Acrescenta dados ao buffer, esvaziando-o quando necessário
+  \note blocos maiores que o buffer são escritos diretamente
+
+  \param out o escritor
+  \param dados os bytes a serem escritos
+  \param len quantidade de bytes
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_escreve(t_escritor *out, const void *dados, size_t len) {
+
+  out->bytes += len;
+  if (out->fd < 0 && out->tam + len > out->cap) {
+      size_t cap = 2*out->cap > out->tam + len ? 2*out->cap : out->tam + len;
+      char *buf = realloc(out->buf, cap);
+      if (!buf) {
+          perror("Falha ao alocar buffer de escrita");
+          return -1;
+      }
+      out->buf = buf;
+      out->cap = cap;
+  }
+  if (out->tam + len > out->cap)
+      if (ES_esvazia(out)) return -1;
+  if (len > out->cap)
+      return escreveTudo(out->fd, dados, len);
+
+  memcpy(out->buf + out->tam, dados, len);
+  out->tam += len;
+  return 0;
+}
+
+/*!
+  \brief Escreve o cabeçalho de um conjunto de dados binário
+
+  \param out o escritor
+  \param n número de valores tabelados
+  \param m número de funções tabeladas
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_escreveCabecalho(t_escritor *out, unsigned int n, unsigned int m) {
+
+  t_cabecalhoBin cab = { .n = n, .m = m, .reservado = 0 };
+  memcpy(cab.magica, ES_MAGICA, 4);
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  cab.n = __builtin_bswap32(cab.n);
+  cab.m = __builtin_bswap32(cab.m);
+#endif
+
+  return ES_escreve(out, &cab, sizeof(cab));
+}
+
+/*!
+  \brief Copia doubles para buf em little-endian
+
+  \param buf buffer com espaço para qtd*sizeof(double) bytes
+  \param v os valores
+  \param qtd quantidade de valores
+  \return número de bytes escritos
+*/
+size_t ES_binarioVetor(char *buf, const double *v, size_t qtd) {
+
+  memcpy(buf, v, qtd*sizeof(double));
+  ajustaEndian((double *) buf, qtd);
+  return qtd*sizeof(double);
+}
+
+/*!
+  \brief Escreve doubles em little-endian
+
+  \param out o escritor
+  \param v os valores
+  \param qtd quantidade de valores
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int ES_escreveDoubles(t_escritor *out, const double *v, size_t qtd) {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  char tmp[sizeof(double)];
+  for (size_t i=0; i < qtd; ++i)
+      if (ES_escreve(out, tmp, ES_binarioVetor(tmp, v+i, 1))) return -1;
+  return 0;
+#else
+  return ES_escreve(out, v, qtd*sizeof(double));
+#endif
+}
+
+/*!
+  \brief Formata double exatamente como printf("%-1.18g")
+
+  \param buf buffer com espaço para ao menos ES_TAM_DBL caracteres
+  \param v o valor
+  \return número de caracteres escritos, sem '\0'
+
+  \note Caminho rápido para 1e-15 <= |v| < 1e18: com v = M*2^E, os 18
+        dígitos significativos são round(M * 5^s * 2^(E+s)), s = 17-X, X o
+        expoente decimal, calculados exatamente em inteiros de 128 bits e
+        arredondados para o par mais próximo como a glibc. Os demais casos
+        (zero, subnormais, inf, nan e valores fora da faixa) usam snprintf()
+*/
+size_t ES_formataDouble(char *buf, double v) {
+
+#ifdef __SIZEOF_INT128__
+  static const unsigned long long pot10u[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL
+  };
+
+  uint64_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  int expBin = (bits >> 52) & 0x7FF;
+
+  if (expBin && expBin != 0x7FF) {
+      const uint64_t M = (bits & ((1ULL << 52) - 1)) | (1ULL << 52);
+      const int E = expBin - 1075;
+      // estimativa de X = floor(log10|v|), corrigida abaixo
+      int X = ((expBin - 1023) * 78913) >> 18;
+      uint64_t D = 0;
+
+      for (int tentativa=0; tentativa < 3; ++tentativa) {
+          int s = 17 - X;
+          if (s < 0 || s > 32) break;
+
+          unsigned __int128 N = M;
+          for (int k=0; k < s; ++k) N *= 5; // M * 5^s < 2^128 para s <= 32
+
+          int k = -(E + s);
+          if (k <= 0) {
+              if (-k >= 64) break;
+              N <<= -k;
+          } else if (k >= 127) {
+              N = 0;
+          } else {
+              unsigned __int128 resto = N & (((unsigned __int128) 1 << k) - 1);
+              unsigned __int128 metade = (unsigned __int128) 1 << (k-1);
+              N >>= k;
+              if (resto > metade || (resto == metade && (N & 1))) ++N;
+          }
+
+          if (N >= pot10u[18]) { ++X; continue; }
+          if (N < pot10u[17]) { --X; continue; }
+          D = (uint64_t) N;
+          break;
+      }
+
+      if (D) {
+          char dig[18];
+          size_t len = 0;
+          int ultimo;
+
+          for (int i=17; i >= 0; --i) {
+              dig[i] = '0' + D % 10;
+              D /= 10;
+          }
+          // último dígito significativo após remover zeros à direita
+          for (ultimo=17; ultimo > 0 && dig[ultimo] == '0'; --ultimo);
+
+          if (bits >> 63) buf[len++] = '-';
+
+          if (X < -4 || X >= 18) {
+              buf[len++] = dig[0];
+              if (ultimo > 0) {
+                  buf[len++] = '.';
+                  memcpy(buf+len, dig+1, ultimo);
+                  len += ultimo;
+              }
+              buf[len++] = 'e';
+              buf[len++] = (X < 0) ? '-' : '+';
+              int ex = (X < 0) ? -X : X;
+              if (ex >= 100) buf[len++] = '0' + ex/100;
+              buf[len++] = '0' + (ex/10)%10;
+              buf[len++] = '0' + ex%10;
+          } else if (X >= 0) {
+              memcpy(buf+len, dig, X+1);
+              len += X+1;
+              if (ultimo > X) {
+                  buf[len++] = '.';
+                  memcpy(buf+len, dig+X+1, ultimo-X);
+                  len += ultimo-X;
+              }
+          } else {
+              buf[len++] = '0';
+              buf[len++] = '.';
+              for (int i=0; i < -X-1; ++i) buf[len++] = '0';
+              memcpy(buf+len, dig, ultimo+1);
+              len += ultimo+1;
+          }
+          return len;
+      }
+  }
+#endif
+
+  return snprintf(buf, ES_TAM_DBL, "%-1.18g", v);
+}
+
+/*!
+  \brief Formata vetor como SL_printMatrix() com m=1
+
+  \param buf buffer com espaço para ao menos n*ES_TAM_DBL+3 caracteres
+  \param v o vetor
+  \param n tamanho do vetor
+  \return número de caracteres escritos
+*/
+size_t ES_formataVetor(char *buf, const double *v, unsigned int n) {
+
+  size_t len = 0;
+
+  buf[len++] = '\n';
+  for (unsigned int j=0; j < n; ++j) {
+      len += ES_formataDouble(buf+len, v[j]);
+      buf[len++] = ' ';
+  }
+  buf[len++] = '\n';
+  buf[len++] = '\n';
+
+  return len;
+}
@@ -0,0 +1,81 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#ifndef __LIBES__
+#define __LIBES__
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// tamanho de cada leitura em bloco da entrada
+#define ES_TAM_BUFFER (1 << 20)
+// maior token numérico aceito
+#define ES_TAM_TOKEN 512
+// maior texto gerado por ES_formataDouble()
+#define ES_TAM_DBL 32
+
+/*
+ * Formato binário: cabeçalho de 16 bytes seguido de x (n doubles) e das m
+ * linhas (m*n doubles), todos little-endian. Conjuntos de dados podem ser
+ * concatenados, como na entrada em texto
+ */
+#define ES_MAGICA "SLB1"
+
+typedef struct {
+    char magica[4];
+    uint32_t n, m;
+    uint32_t reservado;
+} t_cabecalhoBin;
+
+typedef struct {
+    int fd;
+    char *buf;               // dados ainda não consumidos estão em [pos, tam)
+    size_t pos, tam, cap;
+    _Bool mapeado, fim;      // mapeado: buf aponta para o arquivo inteiro (mmap)
+    size_t descartado;       // mapeado: [0, descartado) já devolvido por ES_descarta()
+    unsigned long long bytes; // bytes lidos da entrada
+    double tempo;            // tempo gasto em leitura e conversão (ms)
+} t_leitor;
+
+typedef struct {
+    int fd;                  // -1: escritor em memória (ES_abreEscritorMem())
+    char *buf;               // dados ainda não escritos estão em [0, tam)
+    size_t tam, cap;
+    unsigned long long bytes; // bytes recebidos
+} t_escritor;
+
+
+t_leitor *ES_abreLeitor(int fd);
+void ES_fechaLeitor(t_leitor *in);
+t_leitor *ES_entrada(void);
+void ES_descarta(t_leitor *in);
+
+int ES_leUint(t_leitor *in, unsigned int *v);
+int ES_leDouble(t_leitor *in, double *v);
+int ES_tokensLinha(t_leitor *in, unsigned int *qtd);
+double ES_vazao(t_leitor *in);
+
+int ES_ehBinario(t_leitor *in);
+int ES_leCabecalho(t_leitor *in, unsigned int *n, unsigned int *m);
+double *ES_mapeiaDoubles(t_leitor *in, size_t qtd);
+int ES_leDoubles(t_leitor *in, double *v, size_t qtd);
+
+t_escritor *ES_abreEscritor(int fd);
+t_escritor *ES_abreEscritorMem(size_t cap);
+int ES_despeja(t_escritor *out, t_escritor *mem);
+int ES_fechaEscritor(t_escritor *out);
+int ES_esvazia(t_escritor *out);
+int ES_escreve(t_escritor *out, const void *dados, size_t len);
+int ES_escreveCabecalho(t_escritor *out, unsigned int n, unsigned int m);
+int ES_escreveDoubles(t_escritor *out, const double *v, size_t qtd);
+
+size_t ES_formataDouble(char *buf, double v);
+size_t ES_formataVetor(char *buf, const double *v, unsigned int n);
+size_t ES_binarioVetor(char *buf, const double *v, size_t qtd);
+
+double ES_timestamp(void);
+
+#endif // __LIBES__
@@ -0,0 +1,511 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#endif
+
+#include "libSimd.h"
+
+
+/*!
+  \brief Versões escalares, usadas sem suporte a SIMD e nas sobras dos laços
+*/
+static void elimina_escalar(double *y, const double *x, double a, unsigned int n) {
+    for (unsigned int k=0; k<n; ++k)
+        y[k] -= x[k] * a;
+}
+
+static void eliminaf_escalar(float *y, const float *x, float a, unsigned int n) {
+    for (unsigned int k=0; k<n; ++k)
+        y[k] -= x[k] * a;
+}
+
+static void eliminaPistas_escalar(double *y, const double *x, const double *a, unsigned int n) {
+    for (unsigned int k=0; k<n; ++k)
+        for (unsigned int p=0; p<SIMD_PISTAS; ++p)
+            y[SIMD_PISTAS*k+p] -= x[SIMD_PISTAS*k+p] * a[p];
+}
+
+static void troca_escalar(double *a, double *b, unsigned int n) {
+    double aux;
+    for (unsigned int k=0; k<n; ++k) {
+        aux = a[k];
+        a[k] = b[k];
+        b[k] = aux;
+    }
+}
+
+static void horner_escalar(const double *pol, unsigned int n, const double *t,
+                           double *v, unsigned int q) {
+    double acc;
+    for (unsigned int k=0; k<q; ++k) {
+        acc = pol[n-1];
+        for (unsigned int i=n-1; i-- > 0; )
+            acc = acc * t[k] + pol[i];
+        v[k] = acc;
+    }
+}
+
+/*!
+  \brief Continua a busca do pivô da linha i em diante, a partir do
+         candidato max
+*/
+static unsigned int maxColuna_resto(const double *mat, unsigned int n, unsigned int j,
+                                    unsigned int i, unsigned int max) {
+    for (; i<n; ++i)
+        if (fabs(mat[(size_t)n*i+j]) > fabs(mat[(size_t)n*max+j]))
+            max = i;
+    return max;
+}
+
+static unsigned int maxColuna_escalar(const double *mat, unsigned int n, unsigned int j) {
+    return maxColuna_resto(mat, n, j, j+1, j);
+}
+
+/*!
+  \brief Escolhe, entre os candidatos de cada pista, o de maior valor e,
+         em caso de empate, o de menor índice (o primeiro da coluna)
+*/
+static unsigned int reduzPistas(const double *val, const int64_t *idx, unsigned int pistas) {
+    unsigned int p = 0;
+    for (unsigned int l=1; l<pistas; ++l)
+        if (val[l] > val[p] || (val[l] == val[p] && idx[l] < idx[p]))
+            p = l;
+    return idx[p];
+}
+
+#ifdef SIMD_X86
+
+static void elimina_sse2(double *y, const double *x, double a, unsigned int n) {
+    const __m128d va = _mm_set1_pd(a);
+    unsigned int k = 0;
+
+    for (; k+2 <= n; k += 2)
+        _mm_storeu_pd(y+k, _mm_sub_pd(_mm_loadu_pd(y+k), _mm_mul_pd(_mm_loadu_pd(x+k), va)));
+    elimina_escalar(y+k, x+k, a, n-k);
+}
+
+static void eliminaf_sse2(float *y, const float *x, float a, unsigned int n) {
+    const __m128 va = _mm_set1_ps(a);
+    unsigned int k = 0;
+
+    for (; k+4 <= n; k += 4)
+        _mm_storeu_ps(y+k, _mm_sub_ps(_mm_loadu_ps(y+k), _mm_mul_ps(_mm_loadu_ps(x+k), va)));
+    eliminaf_escalar(y+k, x+k, a, n-k);
+}
+
+static void eliminaPistas_sse2(double *y, const double *x, const double *a, unsigned int n) {
+    const __m128d a0 = _mm_loadu_pd(a), a1 = _mm_loadu_pd(a+2);
+    const __m128d a2 = _mm_loadu_pd(a+4), a3 = _mm_loadu_pd(a+6);
+
+    for (unsigned int k=0; k<n; ++k, y += SIMD_PISTAS, x += SIMD_PISTAS) {
+        _mm_storeu_pd(y,   _mm_sub_pd(_mm_loadu_pd(y),   _mm_mul_pd(_mm_loadu_pd(x),   a0)));
+        _mm_storeu_pd(y+2, _mm_sub_pd(_mm_loadu_pd(y+2), _mm_mul_pd(_mm_loadu_pd(x+2), a1)));
+        _mm_storeu_pd(y+4, _mm_sub_pd(_mm_loadu_pd(y+4), _mm_mul_pd(_mm_loadu_pd(x+4), a2)));
+        _mm_storeu_pd(y+6, _mm_sub_pd(_mm_loadu_pd(y+6), _mm_mul_pd(_mm_loadu_pd(x+6), a3)));
+    }
+}
+
+static void troca_sse2(double *a, double *b, unsigned int n) {
+    unsigned int k = 0;
+    __m128d va, vb;
+
+    for (; k+2 <= n; k += 2) {
+        va = _mm_loadu_pd(a+k);
+        vb = _mm_loadu_pd(b+k);
+        _mm_storeu_pd(a+k, vb);
+        _mm_storeu_pd(b+k, va);
+    }
+    troca_escalar(a+k, b+k, n-k);
+}
+
+static void horner_sse2(const double *pol, unsigned int n, const double *t,
+                        double *v, unsigned int q) {
+    unsigned int k = 0;
+
+    // dois vetores independentes escondem a latência da cadeia de Horner
+    for (; k+4 <= q; k += 4) {
+        __m128d t0 = _mm_loadu_pd(t+k), t1 = _mm_loadu_pd(t+k+2);
+        __m128d a0 = _mm_set1_pd(pol[n-1]), a1 = a0, c;
+        for (unsigned int i=n-1; i-- > 0; ) {
+            c = _mm_set1_pd(pol[i]);
+            a0 = _mm_add_pd(_mm_mul_pd(a0, t0), c);
+            a1 = _mm_add_pd(_mm_mul_pd(a1, t1), c);
+        }
+        _mm_storeu_pd(v+k, a0);
+        _mm_storeu_pd(v+k+2, a1);
+    }
+    horner_escalar(pol, n, t+k, v+k, q-k);
+}
+
+__attribute__((target("avx2")))
+static void elimina_avx2(double *y, const double *x, double a, unsigned int n) {
+    const __m256d va = _mm256_set1_pd(a);
+    unsigned int k = 0;
+
+    for (; k+8 <= n; k += 8) {
+        __m256d y0 = _mm256_loadu_pd(y+k), y1 = _mm256_loadu_pd(y+k+4);
+        y0 = _mm256_sub_pd(y0, _mm256_mul_pd(_mm256_loadu_pd(x+k), va));
+        y1 = _mm256_sub_pd(y1, _mm256_mul_pd(_mm256_loadu_pd(x+k+4), va));
+        _mm256_storeu_pd(y+k, y0);
+        _mm256_storeu_pd(y+k+4, y1);
+    }
+    for (; k+4 <= n; k += 4)
+        _mm256_storeu_pd(y+k, _mm256_sub_pd(_mm256_loadu_pd(y+k),
+                                            _mm256_mul_pd(_mm256_loadu_pd(x+k), va)));
+    elimina_escalar(y+k, x+k, a, n-k);
+}
+
+__attribute__((target("avx2")))
+static void eliminaf_avx2(float *y, const float *x, float a, unsigned int n) {
+    const __m256 va = _mm256_set1_ps(a);
+    unsigned int k = 0;
+
+    for (; k+16 <= n; k += 16) {
+        __m256 y0 = _mm256_loadu_ps(y+k), y1 = _mm256_loadu_ps(y+k+8);
+        y0 = _mm256_sub_ps(y0, _mm256_mul_ps(_mm256_loadu_ps(x+k), va));
+        y1 = _mm256_sub_ps(y1, _mm256_mul_ps(_mm256_loadu_ps(x+k+8), va));
+        _mm256_storeu_ps(y+k, y0);
+        _mm256_storeu_ps(y+k+8, y1);
+    }
+    for (; k+8 <= n; k += 8)
+        _mm256_storeu_ps(y+k, _mm256_sub_ps(_mm256_loadu_ps(y+k),
+                                            _mm256_mul_ps(_mm256_loadu_ps(x+k), va)));
+    eliminaf_escalar(y+k, x+k, a, n-k);
+}
+
+__attribute__((target("avx2")))
+static void eliminaPistas_avx2(double *y, const double *x, const double *a, unsigned int n) {
+    const __m256d a0 = _mm256_loadu_pd(a), a1 = _mm256_loadu_pd(a+4);
+
+    for (unsigned int k=0; k<n; ++k, y += SIMD_PISTAS, x += SIMD_PISTAS) {
+        _mm256_storeu_pd(y,   _mm256_sub_pd(_mm256_loadu_pd(y),   _mm256_mul_pd(_mm256_loadu_pd(x),   a0)));
+        _mm256_storeu_pd(y+4, _mm256_sub_pd(_mm256_loadu_pd(y+4), _mm256_mul_pd(_mm256_loadu_pd(x+4), a1)));
+    }
+}
+
+__attribute__((target("avx2")))
+static void troca_avx2(double *a, double *b, unsigned int n) {
+    unsigned int k = 0;
+    __m256d va, vb;
+
+    for (; k+4 <= n; k += 4) {
+        va = _mm256_loadu_pd(a+k);
+        vb = _mm256_loadu_pd(b+k);
+        _mm256_storeu_pd(a+k, vb);
+        _mm256_storeu_pd(b+k, va);
+    }
+    troca_escalar(a+k, b+k, n-k);
+}
+
+__attribute__((target("avx2")))
+static unsigned int maxColuna_avx2(const double *mat, unsigned int n, unsigned int j) {
+    const __m256d sinal = _mm256_set1_pd(-0.0);
+    const __m256i passo = _mm256_set1_epi64x(4);
+    const __m256i desl = _mm256_set1_epi64x((int64_t)n*4);
+    const double *col = mat + j;
+    unsigned int i = j+1;
+
+    if (n - i < 8) return maxColuna_escalar(mat, n, j);
+
+    // cada pista guarda seu candidato (valor absoluto e linha)
+    __m256d vmax = _mm256_set1_pd(fabs(col[(size_t)n*j]));
+    __m256i imax = _mm256_set1_epi64x(j);
+    __m256i lin = _mm256_setr_epi64x(i, i+1, i+2, i+3);
+    __m256i off = _mm256_setr_epi64x((int64_t)n*i, (int64_t)n*(i+1),
+                                     (int64_t)n*(i+2), (int64_t)n*(i+3));
+
+    for (; i+4 <= n; i += 4) {
+        __m256d v = _mm256_andnot_pd(sinal, _mm256_i64gather_pd(col, off, 8));
+        __m256d maior = _mm256_cmp_pd(v, vmax, _CMP_GT_OQ);
+        vmax = _mm256_blendv_pd(vmax, v, maior);
+        imax = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(imax),
+                                                    _mm256_castsi256_pd(lin), maior));
+        lin = _mm256_add_epi64(lin, passo);
+        off = _mm256_add_epi64(off, desl);
+    }
+
+    double val[4];
+    int64_t idx[4];
+    _mm256_storeu_pd(val, vmax);
+    _mm256_storeu_si256((__m256i *) idx, imax);
+
+    return maxColuna_resto(mat, n, j, i, reduzPistas(val, idx, 4));
+}
+
+__attribute__((target("avx2")))
+static void horner_avx2(const double *pol, unsigned int n, const double *t,
+                        double *v, unsigned int q) {
+    unsigned int k = 0;
+
+    for (; k+16 <= q; k += 16) {
+        __m256d t0 = _mm256_loadu_pd(t+k), t1 = _mm256_loadu_pd(t+k+4);
+        __m256d t2 = _mm256_loadu_pd(t+k+8), t3 = _mm256_loadu_pd(t+k+12);
+        __m256d a0 = _mm256_set1_pd(pol[n-1]), a1 = a0, a2 = a0, a3 = a0, c;
+        for (unsigned int i=n-1; i-- > 0; ) {
+            c = _mm256_set1_pd(pol[i]);
+            a0 = _mm256_add_pd(_mm256_mul_pd(a0, t0), c);
+            a1 = _mm256_add_pd(_mm256_mul_pd(a1, t1), c);
+            a2 = _mm256_add_pd(_mm256_mul_pd(a2, t2), c);
+            a3 = _mm256_add_pd(_mm256_mul_pd(a3, t3), c);
+        }
+        _mm256_storeu_pd(v+k, a0);
+        _mm256_storeu_pd(v+k+4, a1);
+        _mm256_storeu_pd(v+k+8, a2);
+        _mm256_storeu_pd(v+k+12, a3);
+    }
+    for (; k+4 <= q; k += 4) {
+        __m256d t0 = _mm256_loadu_pd(t+k), a0 = _mm256_set1_pd(pol[n-1]);
+        for (unsigned int i=n-1; i-- > 0; )
+            a0 = _mm256_add_pd(_mm256_mul_pd(a0, t0), _mm256_set1_pd(pol[i]));
+        _mm256_storeu_pd(v+k, a0);
+    }
+    horner_escalar(pol, n, t+k, v+k, q-k);
+}
+
+__attribute__((target("avx512f")))
+static void elimina_avx512(double *y, const double *x, double a, unsigned int n) {
+    const __m512d va = _mm512_set1_pd(a);
+    unsigned int k = 0;
+
+    for (; k+16 <= n; k += 16) {
+        __m512d y0 = _mm512_loadu_pd(y+k), y1 = _mm512_loadu_pd(y+k+8);
+        y0 = _mm512_sub_pd(y0, _mm512_mul_pd(_mm512_loadu_pd(x+k), va));
+        y1 = _mm512_sub_pd(y1, _mm512_mul_pd(_mm512_loadu_pd(x+k+8), va));
+        _mm512_storeu_pd(y+k, y0);
+        _mm512_storeu_pd(y+k+8, y1);
+    }
+    if (k < n) {
+        // sobra com máscara, sem laço escalar
+        __mmask8 m = (n-k >= 8) ? 0xFF : (__mmask8)((1u << (n-k)) - 1);
+        __m512d y0 = _mm512_maskz_loadu_pd(m, y+k);
+        y0 = _mm512_sub_pd(y0, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, x+k), va));
+        _mm512_mask_storeu_pd(y+k, m, y0);
+        k += 8;
+        if (k < n) {
+            m = (__mmask8)((1u << (n-k)) - 1);
+            y0 = _mm512_maskz_loadu_pd(m, y+k);
+            y0 = _mm512_sub_pd(y0, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, x+k), va));
+            _mm512_mask_storeu_pd(y+k, m, y0);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+static void eliminaf_avx512(float *y, const float *x, float a, unsigned int n) {
+    const __m512 va = _mm512_set1_ps(a);
+    unsigned int k = 0;
+
+    for (; k+32 <= n; k += 32) {
+        __m512 y0 = _mm512_loadu_ps(y+k), y1 = _mm512_loadu_ps(y+k+16);
+        y0 = _mm512_sub_ps(y0, _mm512_mul_ps(_mm512_loadu_ps(x+k), va));
+        y1 = _mm512_sub_ps(y1, _mm512_mul_ps(_mm512_loadu_ps(x+k+16), va));
+        _mm512_storeu_ps(y+k, y0);
+        _mm512_storeu_ps(y+k+16, y1);
+    }
+    for (; k < n; k += 16) {
+        __mmask16 m = (n-k >= 16) ? 0xFFFF : (__mmask16)((1u << (n-k)) - 1);
+        __m512 y0 = _mm512_maskz_loadu_ps(m, y+k);
+        y0 = _mm512_sub_ps(y0, _mm512_mul_ps(_mm512_maskz_loadu_ps(m, x+k), va));
+        _mm512_mask_storeu_ps(y+k, m, y0);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void eliminaPistas_avx512(double *y, const double *x, const double *a, unsigned int n) {
+    const __m512d va = _mm512_loadu_pd(a);
+    unsigned int k = 0;
+
+    // dois elementos independentes por iteração
+    for (; k+2 <= n; k += 2, y += 2*SIMD_PISTAS, x += 2*SIMD_PISTAS) {
+        __m512d y0 = _mm512_loadu_pd(y), y1 = _mm512_loadu_pd(y+SIMD_PISTAS);
+        y0 = _mm512_sub_pd(y0, _mm512_mul_pd(_mm512_loadu_pd(x), va));
+        y1 = _mm512_sub_pd(y1, _mm512_mul_pd(_mm512_loadu_pd(x+SIMD_PISTAS), va));
+        _mm512_storeu_pd(y, y0);
+        _mm512_storeu_pd(y+SIMD_PISTAS, y1);
+    }
+    if (k < n)
+        _mm512_storeu_pd(y, _mm512_sub_pd(_mm512_loadu_pd(y), _mm512_mul_pd(_mm512_loadu_pd(x), va)));
+}
+
+__attribute__((target("avx512f")))
+static void troca_avx512(double *a, double *b, unsigned int n) {
+    unsigned int k = 0;
+    __m512d va, vb;
+
+    for (; k+8 <= n; k += 8) {
+        va = _mm512_loadu_pd(a+k);
+        vb = _mm512_loadu_pd(b+k);
+        _mm512_storeu_pd(a+k, vb);
+        _mm512_storeu_pd(b+k, va);
+    }
+    if (k < n) {
+        __mmask8 m = (__mmask8)((1u << (n-k)) - 1);
+        va = _mm512_maskz_loadu_pd(m, a+k);
+        vb = _mm512_maskz_loadu_pd(m, b+k);
+        _mm512_mask_storeu_pd(a+k, m, vb);
+        _mm512_mask_storeu_pd(b+k, m, va);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void horner_avx512(const double *pol, unsigned int n, const double *t,
+                          double *v, unsigned int q) {
+    unsigned int k = 0;
+
+    for (; k+32 <= q; k += 32) {
+        __m512d t0 = _mm512_loadu_pd(t+k), t1 = _mm512_loadu_pd(t+k+8);
+        __m512d t2 = _mm512_loadu_pd(t+k+16), t3 = _mm512_loadu_pd(t+k+24);
+        __m512d a0 = _mm512_set1_pd(pol[n-1]), a1 = a0, a2 = a0, a3 = a0, c;
+        for (unsigned int i=n-1; i-- > 0; ) {
+            c = _mm512_set1_pd(pol[i]);
+            a0 = _mm512_add_pd(_mm512_mul_pd(a0, t0), c);
+            a1 = _mm512_add_pd(_mm512_mul_pd(a1, t1), c);
+            a2 = _mm512_add_pd(_mm512_mul_pd(a2, t2), c);
+            a3 = _mm512_add_pd(_mm512_mul_pd(a3, t3), c);
+        }
+        _mm512_storeu_pd(v+k, a0);
+        _mm512_storeu_pd(v+k+8, a1);
+        _mm512_storeu_pd(v+k+16, a2);
+        _mm512_storeu_pd(v+k+24, a3);
+    }
+    // sobra com máscara, 8 pontos por vez
+    for (; k < q; k += 8) {
+        __mmask8 m = (q-k >= 8) ? 0xFF : (__mmask8)((1u << (q-k)) - 1);
+        __m512d t0 = _mm512_maskz_loadu_pd(m, t+k), a0 = _mm512_set1_pd(pol[n-1]);
+        for (unsigned int i=n-1; i-- > 0; )
+            a0 = _mm512_add_pd(_mm512_mul_pd(a0, t0), _mm512_set1_pd(pol[i]));
+        _mm512_mask_storeu_pd(v+k, m, a0);
+    }
+}
+
+__attribute__((target("avx512f")))
+static unsigned int maxColuna_avx512(const double *mat, unsigned int n, unsigned int j) {
+    const __m512i passo = _mm512_set1_epi64(8);
+    const __m512i desl = _mm512_set1_epi64((int64_t)n*8);
+    const double *col = mat + j;
+    unsigned int i = j+1;
+
+    if (n - i < 16) return maxColuna_avx2(mat, n, j);
+
+    __m512d vmax = _mm512_set1_pd(fabs(col[(size_t)n*j]));
+    __m512i imax = _mm512_set1_epi64(j);
+    __m512i lin = _mm512_add_epi64(_mm512_set1_epi64(i), _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    __m512i off = _mm512_setr_epi64((int64_t)n*i, (int64_t)n*(i+1), (int64_t)n*(i+2),
+                                    (int64_t)n*(i+3), (int64_t)n*(i+4), (int64_t)n*(i+5),
+                                    (int64_t)n*(i+6), (int64_t)n*(i+7));
+
+    for (; i+8 <= n; i += 8) {
+        __m512d v = _mm512_abs_pd(_mm512_i64gather_pd(off, col, 8));
+        __mmask8 maior = _mm512_cmp_pd_mask(v, vmax, _CMP_GT_OQ);
+        vmax = _mm512_mask_mov_pd(vmax, maior, v);
+        imax = _mm512_mask_mov_epi64(imax, maior, lin);
+        lin = _mm512_add_epi64(lin, passo);
+        off = _mm512_add_epi64(off, desl);
+    }
+
+    double val[8];
+    int64_t idx[8];
+    _mm512_storeu_pd(val, vmax);
+    _mm512_storeu_si512(idx, imax);
+
+    return maxColuna_resto(mat, n, j, i, reduzPistas(val, idx, 8));
+}
+
+#endif // SIMD_X86
+
+static void (*elimina)(double *, const double *, double, unsigned int) = elimina_escalar;
+static void (*eliminaf)(float *, const float *, float, unsigned int) = eliminaf_escalar;
+static void (*eliminaPistas)(double *, const double *, const double *, unsigned int) = eliminaPistas_escalar;
+static void (*troca)(double *, double *, unsigned int) = troca_escalar;
+static unsigned int (*maxColuna)(const double *, unsigned int, unsigned int) = maxColuna_escalar;
+static void (*horner)(const double *, unsigned int, const double *, double *, unsigned int) = horner_escalar;
+static const char *nivel = "escalar";
+
+/*!
+  \brief Escolhe os kernels uma única vez, antes de main()
+  \note SL_SIMD só reduz o nível, nunca usa instruções que a CPU não tem
+*/
+__attribute__((constructor))
+static void escolheKernels(void) {
+
+#ifdef SIMD_X86
+    const char *pedido = getenv("SL_SIMD");
+    int max = 3;
+
+    if (pedido) {
+        if (!strcmp(pedido, "escalar")) max = 0;
+        else if (!strcmp(pedido, "sse2")) max = 1;
+        else if (!strcmp(pedido, "avx2")) max = 2;
+    }
+
+    __builtin_cpu_init();
+    if (max >= 1 && __builtin_cpu_supports("sse2")) {
+        elimina = elimina_sse2;
+        eliminaf = eliminaf_sse2;
+        eliminaPistas = eliminaPistas_sse2;
+        troca = troca_sse2;
+        horner = horner_sse2;
+        nivel = "sse2";
+    }
+    if (max >= 2 && __builtin_cpu_supports("avx2")) {
+        elimina = elimina_avx2;
+        eliminaf = eliminaf_avx2;
+        eliminaPistas = eliminaPistas_avx2;
+        troca = troca_avx2;
+        maxColuna = maxColuna_avx2;
+        horner = horner_avx2;
+        nivel = "avx2";
+    }
+    if (max >= 3 && __builtin_cpu_supports("avx512f")) {
+        elimina = elimina_avx512;
+        eliminaf = eliminaf_avx512;
+        eliminaPistas = eliminaPistas_avx512;
+        troca = troca_avx512;
+        maxColuna = maxColuna_avx512;
+        horner = horner_avx512;
+        nivel = "avx512";
+    }
+#endif
+}
+
+void SIMD_elimina(double *y, const double *x, double a, unsigned int n) {
+    elimina(y, x, a, n);
+}
+
+void SIMD_eliminaf(float *y, const float *x, float a, unsigned int n) {
+    eliminaf(y, x, a, n);
+}
+
+void SIMD_eliminaPistas(double *y, const double *x, const double *a, unsigned int n) {
+    eliminaPistas(y, x, a, n);
+}
+
+void SIMD_troca(double *a, double *b, unsigned int n) {
+    troca(a, b, n);
+}
+
+unsigned int SIMD_maxColuna(const double *mat, unsigned int n, unsigned int j) {
+    return maxColuna(mat, n, j);
+}
+
+void SIMD_horner(const double *pol, unsigned int n, const double *t, double *v, unsigned int q) {
+    if (!n) {
+        memset(v, 0, q*sizeof(double));
+        return;
+    }
+    horner(pol, n, t, v, q);
+}
+
+const char *SIMD_nivel(void) {
+    return nivel;
+}
@@ -0,0 +1,45 @@
+/**
+ * Luan Machado Bernardt | GRR20190363
+ * Lucas Müller          | GRR20197160
+ */
+
+#ifndef __LIBSIMD__
+#define __LIBSIMD__
+
+/*
+ * Kernels vetoriais das fatorações, com a versão escolhida em tempo de
+ * execução conforme a CPU (AVX-512, AVX2, SSE2 ou escalar). A variável de
+ * ambiente SL_SIMD (escalar, sse2, avx2, avx512) força uma versão menor.
+ * Todos fazem as mesmas operações, na mesma ordem, que os laços escalares
+ * (multiplicação seguida de subtração, sem FMA), logo os resultados são
+ * idênticos em qualquer versão
+ */
+
+// y[k] -= x[k] * a, 0 <= k < n
+void SIMD_elimina(double *y, const double *x, double a, unsigned int n);
+
+// SIMD_elimina() em precisão simples, com o dobro de elementos por vetor
+void SIMD_eliminaf(float *y, const float *x, float a, unsigned int n);
+
+// sistemas intercalados por SIMD_eliminaPistas(): cada elemento ocupa
+// SIMD_PISTAS doubles consecutivos, um de cada sistema (um vetor AVX-512,
+// dois AVX2 ou quatro SSE2)
+#define SIMD_PISTAS 8
+
+// y[SIMD_PISTAS*k+p] -= x[SIMD_PISTAS*k+p] * a[p], 0 <= k < n, 0 <= p < SIMD_PISTAS
+void SIMD_eliminaPistas(double *y, const double *x, const double *a, unsigned int n);
+
+// troca os n elementos de a e b
+void SIMD_troca(double *a, double *b, unsigned int n);
+
+// índice i >= j do primeiro maior |mat[n*i+j]| da coluna j (n x n)
+unsigned int SIMD_maxColuna(const double *mat, unsigned int n, unsigned int j);
+
+// v[k] = pol[0] + t[k]*(pol[1] + ... + t[k]*pol[n-1]), 0 <= k < q (Horner,
+// com os pontos nas pistas dos vetores)
+void SIMD_horner(const double *pol, unsigned int n, const double *t, double *v, unsigned int q);
+
+// nome da versão em uso
+const char *SIMD_nivel(void);
+
+#endif // __LIBSIMD__
@@ -7,8 +7,11 @@
 #include <stdlib.h>
 #include <string.h> // memcpy()
 #include <math.h>
+#include <float.h> // DBL_EPSILON
 
 #include "libSistLin.h"
+#include "libES.h"
+#include "libSimd.h"
 
 
 /*!
@@ -36,14 +39,7 @@ static void trocaElemento(double *a, double *b)
 */
 static void trocaLinha(double *mat, unsigned int i, unsigned int j, unsigned int n) {
 
-    double aux;
-    double *a = &mat[n*i], *b = &mat[n*j];
-
-    for (unsigned int k = 0; k<n; ++k) {
-        aux = *(a+k);
-        *(a+k) = *(b+k);
-        *(b+k) = aux;
-    }    
+    SIMD_troca(&mat[n*i], &mat[n*j], n);
 }
 
 /*!
@@ -56,12 +52,413 @@ static void trocaLinha(double *mat, unsigned int i, unsigned int j, unsigned int
 */
 static unsigned int maxValue(double *matrix, unsigned int n, unsigned int j) {
 
-    unsigned int max = j;
+    return SIMD_maxColuna(matrix, n, j);
+}
 
-    for (int i=max+1; i<n; i++)
-        if (fabs(matrix[n*i+j]) > fabs(matrix[n*max+j]))
-            max = i;
-    return max;
+/*
+ * Kernels de dimensão fixa. FIXA(N) gera triangularizaN() e substituicaoN()
+ * com n constante: o compilador desenrola os laços, elimina as chamadas
+ * indiretas de libSimd e vetoriza cada linha com o tamanho já conhecido.
+ * As operações e a ordem são as de SL_triangulariza_otimiz() e de
+ * SL_substituicao_lote(), logo os fatores e as soluções são idênticos.
+ * DIMENSOES_FIXAS lista as dimensões geradas; SL_FIXAS=0 no ambiente
+ * desativa o despacho, para comparação
+ */
+#define DIMENSOES_FIXAS(X) X(4) X(8) X(10) X(16) X(32)
+
+#define FIXA(N)                                                              \
+static void triangularizaFixa##N(double *U, double *L, int *vetTroca) {     \
+    double m, divi, aux;                                                     \
+    for (int i=0; i<N; i++) {                                                \
+        int pivo = i;                                                        \
+        for (int j=i+1; j<N; ++j)                                            \
+            if (fabs(U[N*j+i]) > fabs(U[N*pivo+i])) pivo = j;                \
+        if (pivo != i) {                                                     \
+            vetTroca[2*i] = i;                                               \
+            vetTroca[2*i+1] = pivo;                                          \
+            for (int k=0; k<N; ++k) {                                        \
+                aux = U[N*i+k]; U[N*i+k] = U[N*pivo+k]; U[N*pivo+k] = aux;   \
+                aux = L[N*i+k]; L[N*i+k] = L[N*pivo+k]; L[N*pivo+k] = aux;   \
+            }                                                                \
+        }                                                                    \
+        divi = U[N*i+i];                                                     \
+        L[N*i+i] = 1.0;                                                      \
+        for (int j=i+1; j<N; j++) {                                          \
+            m = U[N*j+i] / divi;                                             \
+            U[N*j+i] = 0.0;                                                  \
+            L[N*j+i] = m;                                                    \
+            for (int k=i+1; k<N; ++k)                                        \
+                U[N*j+k] -= U[N*i+k] * m;                                    \
+        }                                                                    \
+    }                                                                        \
+}                                                                            \
+                                                                             \
+static inline __attribute__((always_inline))                                 \
+void substituiBlocoFixa##N(const double *L, const double *U,                 \
+                           double W[N][SL_BK_LOTE], const unsigned int bc) { \
+    for (int i=0; i<N; ++i) {                                                \
+        for (int j=i-1; j>=0; --j)                                           \
+            for (unsigned int c=0; c<bc; ++c)                                \
+                W[i][c] -= W[j][c] * L[N*i+j];                               \
+        for (unsigned int c=0; c<bc; ++c)                                    \
+            W[i][c] /= L[N*i+i];                                             \
+    }                                                                        \
+    for (int i=N-1; i>=0; --i) {                                             \
+        for (int j=i+1; j<N; ++j)                                            \
+            for (unsigned int c=0; c<bc; ++c)                                \
+                W[i][c] -= W[j][c] * U[N*i+j];                               \
+        for (unsigned int c=0; c<bc; ++c)                                    \
+            W[i][c] /= U[N*i+i];                                             \
+    }                                                                        \
+}                                                                            \
+                                                                             \
+static void substituicaoFixa##N(const double *L, const double *U, double *X, \
+                                unsigned int m, unsigned int c0, unsigned int fim) { \
+    /* bloco em área local, sem aliasing entre as linhas; o bloco cheio */   \
+    /* tem largura constante e dispensa as sobras dos laços */               \
+    double W[N][SL_BK_LOTE];                                                 \
+    const unsigned int bc = fim-c0;                                          \
+    for (int i=0; i<N; ++i)                                                  \
+        memcpy(W[i], X + (size_t)m*i + c0, bc*sizeof(double));              \
+    if (bc == SL_BK_LOTE)                                                    \
+        substituiBlocoFixa##N(L, U, W, SL_BK_LOTE);                          \
+    else                                                                     \
+        substituiBlocoFixa##N(L, U, W, bc);                                  \
+    for (int i=0; i<N; ++i)                                                  \
+        memcpy(X + (size_t)m*i + c0, W[i], bc*sizeof(double));              \
+}
+
+DIMENSOES_FIXAS(FIXA)
+
+typedef struct {
+    unsigned int n;
+    void (*triangulariza)(double *U, double *L, int *vetTroca);
+    void (*substituicao)(const double *L, const double *U, double *X,
+                         unsigned int m, unsigned int c0, unsigned int fim);
+} t_fixa;
+
+#define ENTRADA_FIXA(N) { N, triangularizaFixa##N, substituicaoFixa##N },
+static const t_fixa fixas[] = { DIMENSOES_FIXAS(ENTRADA_FIXA) };
+
+static _Bool usaFixas = 1;
+
+__attribute__((constructor))
+static void escolheFixas(void) {
+    const char *pedido = getenv("SL_FIXAS");
+    usaFixas = !(pedido && !strcmp(pedido, "0"));
+}
+
+/*!
+  \brief Kernel de dimensão fixa para n
+
+  \return o kernel. NULL se não há kernel para n ou se estão desativados
+*/
+static const t_fixa *kernelFixo(unsigned int n) {
+    if (!usaFixas) return NULL;
+    for (unsigned int k=0; k<sizeof(fixas)/sizeof(fixas[0]); ++k)
+        if (fixas[k].n == n) return &fixas[k];
+    return NULL;
+}
+
+/*!
+ * \brief Substituições L*y = b e L^T*x = y com L compactado (SL_cholesky())
+ *
+ * \param C fator de Cholesky compactado por linhas
+ * \param n dimensão do sistema
+ * \param X matriz n x m de termos independentes, sobrescrita pelas soluções
+ * \param m número de colunas de X
+ * \param c0 primeira coluna de X a resolver
+ * \param fim coluna seguinte à última a resolver
+ *
+ * \note a retrossubstituição é feita por colunas de L^T, isto é, linhas
+ *       de L, para percorrer C sequencialmente
+ */
+static void substituicaoCholesky(const double *C, int n, double *X, unsigned int m,
+                                 unsigned int c0, unsigned int fim) {
+
+  const double *ci;
+  double *xi, *xj;
+
+  for (int i=0; i<n; ++i) {
+      ci = C + (size_t)i*(i+1)/2;
+      xi = X + (size_t)m*i;
+      for (int j=0; j<i; ++j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xi+c0, xj+c0, ci[j], fim-c0);
+      }
+      for (unsigned int c=c0; c<fim; ++c)
+          xi[c] /= ci[i];
+  }
+  for (int i=n-1; i>=0; --i) {
+      ci = C + (size_t)i*(i+1)/2;
+      xi = X + (size_t)m*i;
+      for (unsigned int c=c0; c<fim; ++c)
+          xi[c] /= ci[i];
+      for (int j=0; j<i; ++j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xj+c0, xi+c0, ci[j], fim-c0);
+      }
+  }
+}
+
+/*!
+ * \brief Substituições L*y = P*b e U*x = y com L e U no mesmo arranjo
+ *        (SL_triangulariza_compacta())
+ *
+ * \param LU fatores compactos: L abaixo da diagonal (diagonal unitária
+ *           implícita) e U no triângulo superior
+ * \param piv a linha i foi trocada com a linha piv[i] na etapa i
+ * \param n dimensão do sistema
+ * \param X matriz n x m de termos independentes, sobrescrita pelas soluções
+ * \param m número de colunas de X
+ * \param c0 primeira coluna de X a resolver
+ * \param fim coluna seguinte à última a resolver
+ */
+static void substituicaoCompacta(const double *LU, const int *piv, int n, double *X,
+                                 unsigned int m, unsigned int c0, unsigned int fim) {
+
+  double *xi, *xj;
+
+  for (int i=0; i<n; ++i) {
+      xi = X + (size_t)m*i;
+      xj = X + (size_t)m*piv[i];
+      for (unsigned int c=c0; c<fim; ++c)
+          trocaElemento(xi+c, xj+c);
+  }
+
+  for (int i=0; i<n; ++i) {
+      xi = X + (size_t)m*i;
+      for (int j=i-1; j>=0; --j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xi+c0, xj+c0, LU[(size_t)n*i+j], fim-c0);
+      }
+  }
+  for (int i=n-1; i>=0; --i) {
+      xi = X + (size_t)m*i;
+      for (int j=i+1; j<n; ++j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xi+c0, xj+c0, LU[(size_t)n*i+j], fim-c0);
+      }
+      for (unsigned int c=c0; c<fim; ++c)
+          xi[c] /= LU[(size_t)n*i+i];
+  }
+}
+
+/*!
+ * \brief Substituições L*y = P*b e U*x = y com as linhas de LU indexadas
+ *        por perm (SL_triangulariza_indireta())
+ *
+ * \param LU fatores compactos, linha lógica i na linha física perm[i]
+ * \param perm a permutação
+ * \param n dimensão do sistema
+ * \param W matriz n x bc com P*b já aplicada, sobrescrita pelas soluções
+ * \param bc número de colunas de W
+ */
+static void substituicaoIndireta(const double *LU, const int *perm, int n,
+                                 double *W, unsigned int bc) {
+
+  const double *ri;
+  double *wi;
+
+  for (int i=0; i<n; ++i) {
+      ri = LU + (size_t)n*perm[i];
+      wi = W + (size_t)bc*i;
+      for (int j=i-1; j>=0; --j)
+          SIMD_elimina(wi, W + (size_t)bc*j, ri[j], bc);
+  }
+  for (int i=n-1; i>=0; --i) {
+      ri = LU + (size_t)n*perm[i];
+      wi = W + (size_t)bc*i;
+      for (int j=i+1; j<n; ++j)
+          SIMD_elimina(wi, W + (size_t)bc*j, ri[j], bc);
+      for (unsigned int c=0; c<bc; ++c)
+          wi[c] /= ri[i];
+  }
+}
+
+/*!
+ * \brief substituicaoCompacta() com os fatores em precisão simples
+ *        (SL_triangulariza_mista()); as contas são feitas em double
+ */
+static void substituicaoMista(const float *LU, const int *piv, int n, double *X,
+                              unsigned int m, unsigned int c0, unsigned int fim) {
+
+  double *xi, *xj;
+
+  for (int i=0; i<n; ++i) {
+      xi = X + (size_t)m*i;
+      xj = X + (size_t)m*piv[i];
+      for (unsigned int c=c0; c<fim; ++c)
+          trocaElemento(xi+c, xj+c);
+  }
+
+  for (int i=0; i<n; ++i) {
+      xi = X + (size_t)m*i;
+      for (int j=i-1; j>=0; --j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xi+c0, xj+c0, LU[(size_t)n*i+j], fim-c0);
+      }
+  }
+  for (int i=n-1; i>=0; --i) {
+      xi = X + (size_t)m*i;
+      for (int j=i+1; j<n; ++j) {
+          xj = X + (size_t)m*j;
+          SIMD_elimina(xi+c0, xj+c0, LU[(size_t)n*i+j], fim-c0);
+      }
+      for (unsigned int c=c0; c<fim; ++c)
+          xi[c] /= LU[(size_t)n*i+i];
+  }
+}
+
+/*!
+ * \brief Resolve as colunas [c0, fim) de X com os fatores em precisão
+ *        simples e refinamento iterativo em double: r = b - A*x com
+ *        SL->A, d = (LU)^-1 * r, x += d
+ *
+ * \param SL o sistema linear, com SL->LUf
+ * \param X matriz n x m de termos independentes, sobrescrita pelas soluções
+ * \param W área n x 2*SL_BK_LOTE da thread
+ * \return número de iterações de refinamento, ou -1 se não convergiu em
+ *         SL_MAX_REFINAMENTO iterações ou o erro parou de cair; nesse
+ *         caso as colunas voltam a conter os termos independentes
+ *
+ * \note para quando o erro regressivo por componentes de toda coluna,
+ *       max_i |r_i| / (|A||x| + |b|)_i, é no máximo SL_TOL_REFINAMENTO *
+ *       eps, como o dgerfs do LAPACK. Um teste só com normas aceitaria a
+ *       solução em float de matrizes mal escaladas (pontos longe de
+ *       [-1, 1]), em que as linhas de A diferem em ordens de grandeza
+ */
+static int refinaMista(t_sist *SL, double *X, unsigned int m, unsigned int c0,
+                       unsigned int fim, double *W) {
+
+  const int n = SL->n;
+  const unsigned int bc = fim-c0;
+  double *B = W, *R = W + (size_t)n*bc, *ri, *xi, *xj, a;
+  double escala[SL_BK_LOTE], erro[SL_BK_LOTE], emax, eant = HUGE_VAL;
+
+  for (int i=0; i<n; ++i)
+      memcpy(B + (size_t)bc*i, X + (size_t)m*i + c0, bc*sizeof(double));
+  substituicaoMista(SL->LUf, SL->piv, n, X, m, c0, fim);
+
+  for (int it=0; it <= SL_MAX_REFINAMENTO; ++it) {
+      // R = B - A*X em double, com o erro regressivo de cada coluna
+      memcpy(R, B, (size_t)n*bc*sizeof(double));
+      for (unsigned int c=0; c<bc; ++c)
+          erro[c] = 0.0;
+      for (int i=0; i<n; ++i) {
+          ri = R + (size_t)bc*i;
+          for (unsigned int c=0; c<bc; ++c)
+              escala[c] = fabs(ri[c]);
+          for (int j=0; j<n; ++j) {
+              xj = X + (size_t)m*j + c0;
+              a = SL->A[(size_t)n*i+j];
+              SIMD_elimina(ri, xj, a, bc);
+              for (unsigned int c=0; c<bc; ++c)
+                  escala[c] += fabs(a) * fabs(xj[c]);
+          }
+          // resíduo nulo com escala nula (linha e x nulos) não é erro
+          for (unsigned int c=0; c<bc; ++c)
+              if (ri[c] != 0.0 && !(fabs(ri[c]) <= erro[c] * escala[c]))
+                  erro[c] = fabs(ri[c]) / escala[c];
+      }
+
+      emax = 0.0;
+      for (unsigned int c=0; c<bc; ++c)
+          if (!(erro[c] <= emax)) emax = erro[c]; // NaN também interrompe
+      if (emax <= SL_TOL_REFINAMENTO * DBL_EPSILON) return it;
+
+      // sem convergência ou sem redução de ao menos metade do erro
+      if (it == SL_MAX_REFINAMENTO || !(emax <= 0.5 * eant)) break;
+      eant = emax;
+
+      substituicaoMista(SL->LUf, SL->piv, n, R, bc, 0, bc);
+      for (int i=0; i<n; ++i) {
+          xi = X + (size_t)m*i + c0;
+          ri = R + (size_t)bc*i;
+          for (unsigned int c=0; c<bc; ++c)
+              xi[c] += ri[c];
+      }
+  }
+
+  for (int i=0; i<n; ++i)
+      memcpy(X + (size_t)m*i + c0, B + (size_t)bc*i, bc*sizeof(double));
+  return -1;
+}
+
+/*!
+ * \brief Troca os fatores em float de SL por sua LU compacta em double
+ *
+ * \note a LU ocupa o espaço que SL_fatoracao() reservou junto com os fatores
+ *       em float (SL->LUd) e herda seu vetor de permutação: nada é alocado,
+ *       e os novos fatores vivem tanto quanto os originais
+ */
+static int recorreCompacta(t_sist *SL) {
+
+  SL_liberaMem(SL->LUf);
+  SL->LUf = NULL;
+  SL->metodo = SL_LU_COMPACTA;
+  ++SL->fatoracoes;
+  return SL_triangulariza_compacta(SL, SL->bk);
+}
+
+/*!
+ * \brief SL_substituicao_lote() com os fatores em precisão simples
+ *
+ * \note blocos de SL_BK_LOTE colunas refinados em paralelo. Se algum não
+ *       converge (A mal condicionada demais para a LU em float, como a
+ *       de Vandermonde de grau alto), SL passa à LU compacta em double
+ *       (recorreCompacta()) e esses blocos são resolvidos com ela
+ */
+static int substituicaoLoteMista(t_sist *SL, double *X, unsigned int m) {
+
+  const int n = SL->n;
+  const unsigned int blocos = (m + SL_BK_LOTE - 1) / SL_BK_LOTE;
+  unsigned long refin = 0;
+  int falha = 0, recorre = 0;
+
+  char *naoConvergiu = SL_alocaMem(blocos ? blocos : 1);
+  if (!naoConvergiu) {
+      perror("Falha ao alocar vetor de blocos");
+      return -1;
+  }
+
+  #pragma omp parallel reduction(|:falha) reduction(+:refin)
+  {
+    double *W = SL_alocaMem(2*(size_t)n*SL_BK_LOTE*sizeof(double));
+    if (!W) {
+        perror("Falha ao alocar blocos do refinamento");
+        falha = 1;
+    }
+
+    #pragma omp for schedule(static)
+    for (unsigned int b=0; b<blocos; ++b) {
+        if (!W) continue;
+        unsigned int c0 = b*SL_BK_LOTE, fim = (c0+SL_BK_LOTE < m) ? c0+SL_BK_LOTE : m;
+        int it = refinaMista(SL, X, m, c0, fim, W);
+        if (it < 0) naoConvergiu[b] = 1;
+        else refin += it;
+    }
+
+    SL_liberaMem(W);
+  }
+  SL->refinamentos += refin;
+
+  for (unsigned int b=0; b<blocos; ++b)
+      recorre |= naoConvergiu[b];
+
+  if (recorre && !falha) {
+      if (recorreCompacta(SL)) falha = 1;
+
+      #pragma omp parallel for schedule(static)
+      for (unsigned int b=0; b<blocos; ++b) {
+          unsigned int c0 = b*SL_BK_LOTE, fim = (c0+SL_BK_LOTE < m) ? c0+SL_BK_LOTE : m;
+          if (!falha && naoConvergiu[b])
+              substituicaoCompacta(SL->LU, SL->piv, n, X, m, c0, fim);
+      }
+  }
+
+  SL_liberaMem(naoConvergiu);
+  return falha ? -1 : 0;
 }
 
 /*!
@@ -72,9 +469,41 @@ static unsigned int maxValue(double *matrix, unsigned int n, unsigned int j) {
  */
 void SL_substituicao(t_sist *SL, double *pol) {
 
+  if (SL->LUf) {
+      memcpy(pol, SL->B, SL->n * sizeof(double));
+      SL_substituicao_lote(SL, pol, 1);
+      return;
+  }
+
+  ++SL->reusos;
+
+  if (SL->C) {
+      memcpy(pol, SL->B, SL->n * sizeof(double));
+      substituicaoCholesky(SL->C, SL->n, pol, 1, 0, 1);
+      return;
+  }
+  if (SL->perm) {
+      for (int i=0; i<SL->n; ++i)
+          pol[i] = SL->B[SL->perm[i]];
+      substituicaoIndireta(SL->LU, SL->perm, SL->n, pol, 1);
+      return;
+  }
+  if (SL->LU) {
+      memcpy(pol, SL->B, SL->n * sizeof(double));
+      substituicaoCompacta(SL->LU, SL->piv, SL->n, pol, 1, 0, 1);
+      return;
+  }
+
   for (int i=0; i<SL->n; ++i)
     trocaElemento(&SL->B[SL->vetTroca[2*i]], &SL->B[SL->vetTroca[2*i+1]]);
 
+  const t_fixa *fixa = kernelFixo(SL->n);
+  if (fixa) {
+      memcpy(pol, SL->B, SL->n * sizeof(double));
+      fixa->substituicao(SL->L, SL->U, pol, 1, 0, 1);
+      return;
+  }
+
   for (int i=0; i<SL->n; ++i) {
       pol[i] = SL->B[i];
       for (int j=i-1; j>=0; --j)
@@ -89,7 +518,297 @@ void SL_substituicao(t_sist *SL, double *pol) {
 }
 
 /*!
-  \brief Aloca matriz
+ * \brief Substituição LU para múltiplos termos independentes
+ *
+ * \param SL o sistema linear contendo L e U previamente obtidos
+ * \param X matriz n x m com um termo independente por coluna, sobrescrita
+ *          pelas soluções correspondentes
+ * \param m número de termos independentes
+ *
+ * \return 0 se sucesso e -1 em caso de falha
+ *
+ * \note Os termos independentes são processados em blocos de SL_BK_LOTE
+ *       colunas, de forma que L e U sejam lidos uma vez por bloco e não
+ *       uma vez por termo independente. Os blocos são independentes e
+ *       divididos entre as threads OpenMP. Com a permutação indireta
+ *       (SL->perm), cada bloco é reunido na ordem de perm em uma área
+ *       própria da thread, resolvido nela e copiado de volta. Com os
+ *       fatores em float (SL_LU_MISTA), se o refinamento não converge a
+ *       chamada refatora SL em double, no espaço reservado por
+ *       SL_fatoracao(), sem alocar fatores
+ */
+int SL_substituicao_lote(t_sist *SL, double *X, unsigned int m) {
+
+  const int n = SL->n;
+  const t_fixa *fixa = kernelFixo(n);
+  double *xi, *xj, *W;
+  unsigned int fim, bc;
+  int falha = 0;
+
+  SL->reusos += m;
+  if (SL->LUf) return substituicaoLoteMista(SL, X, m);
+
+  #pragma omp parallel private(xi, xj, fim, bc, W) reduction(|:falha)
+  {
+  W = NULL;
+  if (SL->perm) {
+      W = SL_alocaMem((size_t)n*SL_BK_LOTE*sizeof(double));
+      if (!W) {
+          perror("Falha ao alocar bloco de termos independentes");
+          falha = 1;
+      }
+  }
+
+  #pragma omp for schedule(static)
+  for (unsigned int c0=0; c0<m; c0 += SL_BK_LOTE) {
+      fim = (c0+SL_BK_LOTE < m) ? c0+SL_BK_LOTE : m;
+
+      if (SL->perm) {
+          if (!W) continue;
+          bc = fim-c0;
+          for (int i=0; i<n; ++i)
+              memcpy(W + (size_t)bc*i, X + (size_t)m*SL->perm[i] + c0, bc*sizeof(double));
+          substituicaoIndireta(SL->LU, SL->perm, n, W, bc);
+          for (int i=0; i<n; ++i)
+              memcpy(X + (size_t)m*i + c0, W + (size_t)bc*i, bc*sizeof(double));
+          continue;
+      }
+      if (SL->C) {
+          substituicaoCholesky(SL->C, n, X, m, c0, fim);
+          continue;
+      }
+      if (SL->LU) {
+          substituicaoCompacta(SL->LU, SL->piv, n, X, m, c0, fim);
+          continue;
+      }
+
+      for (int i=0; i<n; ++i) {
+          xi = X + (size_t)m*SL->vetTroca[2*i];
+          xj = X + (size_t)m*SL->vetTroca[2*i+1];
+          for (unsigned int c=c0; c<fim; ++c)
+              trocaElemento(xi+c, xj+c);
+      }
+
+      if (fixa) {
+          fixa->substituicao(SL->L, SL->U, X, m, c0, fim);
+          continue;
+      }
+
+      for (int i=0; i<n; ++i) {
+          xi = X + (size_t)m*i;
+          for (int j=i-1; j>=0; --j) {
+              xj = X + (size_t)m*j;
+              SIMD_elimina(xi+c0, xj+c0, SL->L[n*i+j], fim-c0);
+          }
+          for (unsigned int c=c0; c<fim; ++c)
+              xi[c] /= SL->L[n*i+i];
+      }
+      for (int i=n-1; i>=0; --i) {
+          xi = X + (size_t)m*i;
+          for (int j=i+1; j<n; ++j) {
+              xj = X + (size_t)m*j;
+              SIMD_elimina(xi+c0, xj+c0, SL->U[n*i+j], fim-c0);
+          }
+          for (unsigned int c=c0; c<fim; ++c)
+              xi[c] /= SL->U[n*i+i];
+      }
+  }
+
+  SL_liberaMem(W);
+  }
+
+  return falha ? -1 : 0;
+}
+
+// arena usada por SL_alocaMem() na thread atual (NULL: heap). Cada thread
+// ativa a sua; as threads OpenMP criadas por ela usam o heap, de forma que
+// memória da arena só é alocada e liberada pela thread dona
+static _Thread_local t_arena *arenaAtual = NULL;
+
+/*!
+  \brief Cria arena alinhada em SL_ALINHAMENTO bytes
+
+  \param cap capacidade inicial em bytes (pode ser 0)
+  \return ponteiro para t_arena. NULL se houve erro de alocação
+*/
+t_arena *SL_arenaCria(size_t cap) {
+
+  t_arena *arena = calloc(1, sizeof(t_arena));
+  if (!arena) return NULL;
+
+  cap = (cap + SL_ALINHAMENTO-1) & ~(size_t)(SL_ALINHAMENTO-1);
+  if (cap) {
+      arena->base = aligned_alloc(SL_ALINHAMENTO, cap);
+      if (!arena->base) {
+          perror("Falha ao alocar arena");
+          free(arena);
+          return NULL;
+      }
+      arena->cap = cap;
+  }
+  return arena;
+}
+
+/*!
+  \brief Torna a arena a origem das alocações SL_* da thread atual
+
+  \param arena a arena (NULL volta a usar o heap)
+*/
+void SL_arenaAtiva(t_arena *arena) {
+
+  arenaAtual = arena;
+}
+
+/*!
+  \brief Libera todas as alocações feitas na arena de uma vez
+  \note se o último ciclo precisou de mais que a capacidade (excedente
+        alocado no heap), a arena é realocada com o maior uso observado,
+        de forma que conjuntos de dados semelhantes caibam inteiros nela
+
+  \param arena a arena
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_arenaReinicia(t_arena *arena) {
+
+  if (arena->usado + arena->excedente > arena->pico)
+      arena->pico = arena->usado + arena->excedente;
+
+  if (arena->pico > arena->cap) {
+      free(arena->base);
+      arena->cap = 0;
+      arena->base = aligned_alloc(SL_ALINHAMENTO, arena->pico);
+      if (!arena->base) {
+          perror("Falha ao alocar arena");
+          return -1;
+      }
+      arena->cap = arena->pico;
+  }
+  arena->usado = arena->excedente = 0;
+
+  return 0;
+}
+
+/*!
+  \brief Garante capacidade para um ciclo da arena antes de sua primeira
+         alocação, de forma que nada dele vá para o heap
+  \note a arena deve estar vazia (recém-criada ou reiniciada); se não
+        estiver, nada é feito e o que não couber vai para o heap
+
+  \param arena a arena
+  \param tam bytes que o ciclo vai alocar
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_arenaPrepara(t_arena *arena, size_t tam) {
+
+  tam = (tam + SL_ALINHAMENTO-1) & ~(size_t)(SL_ALINHAMENTO-1);
+  if (arena->usado || arena->excedente || tam <= arena->cap) return 0;
+
+  free(arena->base);
+  arena->cap = 0;
+  arena->base = aligned_alloc(SL_ALINHAMENTO, tam);
+  if (!arena->base) {
+      perror("Falha ao alocar arena");
+      return -1;
+  }
+  arena->cap = tam;
+
+  return 0;
+}
+
+/*!
+  \brief Posição atual da arena ativa, para SL_arenaVolta()
+
+  \return bytes já entregues pela arena (0 sem arena ativa)
+*/
+size_t SL_arenaMarca(void) {
+
+  return arenaAtual ? arenaAtual->usado : 0;
+}
+
+/*!
+  \brief Devolve à arena ativa tudo o que foi alocado dela depois da marca
+  \note para temporários de um laço: nenhum ponteiro obtido depois de
+        SL_arenaMarca() pode ser usado depois
+
+  \param marca valor de SL_arenaMarca()
+*/
+void SL_arenaVolta(size_t marca) {
+
+  if (!arenaAtual || marca > arenaAtual->usado) return;
+  if (arenaAtual->usado + arenaAtual->excedente > arenaAtual->pico)
+      arenaAtual->pico = arenaAtual->usado + arenaAtual->excedente;
+  arenaAtual->usado = marca;
+}
+
+/*!
+  \brief Libera a arena
+  \note nenhum ponteiro obtido dela pode ser usado depois
+
+  \param arena a arena
+*/
+void SL_arenaLibera(t_arena *arena) {
+
+  if (!arena) return;
+  if (arenaAtual == arena) SL_arenaAtiva(NULL);
+  free(arena->base);
+  free(arena);
+}
+
+/*!
+  \brief Reserva memória alinhada em SL_ALINHAMENTO bytes, da arena ativa
+         ou do heap, sem zerá-la
+
+  \param tam tamanho em bytes (arredondado para múltiplo do alinhamento)
+  \return ponteiro para a memória. NULL se houve erro de alocação
+*/
+static void *reservaMem(size_t tam) {
+
+  void *p;
+
+  tam = (tam + SL_ALINHAMENTO-1) & ~(size_t)(SL_ALINHAMENTO-1);
+  if (!tam) tam = SL_ALINHAMENTO;
+
+  if (arenaAtual) {
+      if (arenaAtual->cap - arenaAtual->usado >= tam) {
+          p = arenaAtual->base + arenaAtual->usado;
+          arenaAtual->usado += tam;
+          return p;
+      }
+      arenaAtual->excedente += tam;
+  }
+
+  return aligned_alloc(SL_ALINHAMENTO, tam);
+}
+
+/*!
+  \brief Aloca memória zerada, alinhada em SL_ALINHAMENTO bytes, da arena
+         ativa ou do heap
+
+  \param tam tamanho em bytes
+  \return ponteiro para a memória. NULL se houve erro de alocação
+*/
+void *SL_alocaMem(size_t tam) {
+
+  void *p = reservaMem(tam);
+  return p ? memset(p, 0, tam) : NULL;
+}
+
+/*!
+  \brief Libera memória obtida por SL_alocaMem()
+  \note memória da arena só é devolvida em SL_arenaReinicia()
+
+  \param p o ponteiro (pode ser NULL)
+*/
+void SL_liberaMem(void *p) {
+
+  if (arenaAtual && (char *) p >= arenaAtual->base
+                 && (char *) p < arenaAtual->base + arenaAtual->cap)
+      return;
+  free(p);
+}
+
+/*!
+  \brief Aloca matriz zerada (em paralelo a partir de SL_PRIMEIRO_TOQUE bytes)
 
   \param n número de valores tabelados
   \param m número de funções tabeladas
@@ -98,11 +817,20 @@ void SL_substituicao(t_sist *SL, double *pol) {
 */
 double* SL_alocaMatrix(unsigned int n, unsigned int m) {
 
-  double *newMatrix = calloc(1, n*m*sizeof(double));
+  const size_t tam = (size_t)n*m*sizeof(double);
+  double *newMatrix = reservaMem(tam);
   if (!newMatrix) {
     perror("Falha ao alocar matriz");
     return NULL;
   }
+
+  // primeiro toque: cada thread zera as linhas que receberia em um laço
+  // schedule(static) sobre as linhas, como o de vandermondeLadrilhos()
+  if (tam < SL_PRIMEIRO_TOQUE) return memset(newMatrix, 0, tam);
+
+  #pragma omp parallel for schedule(static)
+  for (unsigned int i=0; i<n; ++i)
+      memset(newMatrix + (size_t)m*i, 0, m*sizeof(double));
   return newMatrix;
 }
 
@@ -116,28 +844,22 @@ double* SL_alocaMatrix(unsigned int n, unsigned int m) {
 */
 t_sist *SL_aloca(unsigned int n, unsigned int m) {
 
-	t_sist *newSL = calloc(1, sizeof(t_sist));
+	t_sist *newSL = SL_alocaMem(sizeof(t_sist));
 	if (!newSL) return NULL;
 
 	newSL->A = SL_alocaMatrix(n, m);
 	if (!newSL->A) {
-      free(newSL);
+      SL_liberaMem(newSL);
       return NULL;
   }
-  newSL->x = calloc(1, n * sizeof(double));
+  newSL->x = SL_alocaMem(n * sizeof(double));
   if (!newSL->x) {
       perror("Falha ao alocar matriz");
-      free(newSL->A);
-      free(newSL);
+      SL_liberaMem(newSL->A);
+      SL_liberaMem(newSL);
       return NULL;
   }
-  newSL->L = SL_alocaMatrix(n, n);
-  if (!newSL->L) {
-    free(newSL->x);
-    free(newSL->A);
-    free(newSL);
-    return NULL;
-  }
+  // L, U e vetTroca são alocados pela fatoração escolhida (SL_fatoracao())
 
   newSL->n = n;
   newSL->m = m;
@@ -152,88 +874,249 @@ t_sist *SL_aloca(unsigned int n, unsigned int m) {
 */
 void SL_libera(t_sist *SL) {
 
-  free(SL->A);
-  free(SL->x);
-  free(SL->L);
-  if (SL->U) free(SL->U);
-  if (SL->vetTroca) free(SL->vetTroca);
-  free(SL);
+  if (!SL->mapeado) {
+      SL_liberaMem(SL->A);
+      SL_liberaMem(SL->x);
+  }
+  SL_liberaMem(SL->L);
+  SL_liberaMem(SL->C);
+  if (SL->LU != SL->A) SL_liberaMem(SL->LU);
+  SL_liberaMem(SL->LUf);
+  SL_liberaMem(SL->LUd);
+  SL_liberaMem(SL->piv);
+  SL_liberaMem(SL->perm);
+  SL_liberaMem(SL->QR);
+  SL_liberaMem(SL->tau);
+  SL_liberaMem(SL->U);
+  SL_liberaMem(SL->vetTroca);
+  SL_liberaMem(SL);
 }
 
 /*!
-  \brief Le valores de stdin para preencher t_sist
-
-  \return ponteiro para t_sist. NULL se houve erro de alocação
+  \brief Le o cabeçalho de um conjunto de dados (n, m e x), sem as linhas
+  \note aceita tanto o formato texto quanto o binário de ES_MAGICA. Se a
+        entrada binária está mapeada em memória, SL->x aponta diretamente
+        para ela, sem cópia. SL->A fica NULL: as linhas são lidas depois,
+        em blocos, por SL_leituraLinhas(), ou inteiras por SL_leituraMatriz()
+
+  \return ponteiro para t_sist. NULL se houve erro de leitura ou alocação
+          ou fim da entrada
 */
-t_sist *SL_leitura() {
+t_sist *SL_leituraCabecalho() {
 
-    // extrai a linha contendo a ordem da matriz
+    t_leitor *in = ES_entrada();
+    if (!in) return NULL;
+
+    double tempo = ES_timestamp();
     unsigned int n=0, m=0;
-    if (EOF == scanf("%d", &n)) return NULL;
-    if (EOF == scanf("%d", &m)) return NULL;
+    _Bool binario = ES_ehBinario(in);
+
+    // extrai a linha contendo a ordem da matriz
+    if (binario ? ES_leCabecalho(in, &n, &m)
+                : ES_leUint(in, &n) || ES_leUint(in, &m)) return NULL;
     if (!n || !m) {
         fputs("Não foi possível obter ordem de matriz\n", stderr);
         return NULL;
     }
 
-    // realiza alocação do Sistema Linear
-    t_sist *newSL = SL_aloca(n, m);
+    t_sist *newSL = SL_alocaMem(sizeof(t_sist));
     if (!newSL) {
         fputs("Não foi possível alocar 'newSL'\n", stderr);
         return NULL;
     }
-
-    for (unsigned int i=0; i < newSL->n; ++i) {
-        if (EOF == scanf("%lf", &newSL->x[i])) {
-            perror("Falha de leitura");
+    newSL->n = n;
+    newSL->m = m;
+    newSL->binario = binario;
+
+    if (binario && (newSL->x = ES_mapeiaDoubles(in, n)))
+        newSL->mapeado = 1;
+    else {
+        newSL->x = SL_alocaMem(n * sizeof(double));
+        if (!newSL->x) {
+            perror("Falha ao alocar matriz");
+            SL_libera(newSL);
             return NULL;
         }
-    }
-
-    // extrai as linhas contendo os elementos da matriz
-    for (unsigned int i=0; i < newSL->m; ++i) {
-        for (unsigned int j=0; j < newSL->n; ++j) {
-            if (EOF == scanf("%lf", &newSL->A[n*i+j])) {
-                perror("Falha de leitura");
-                return NULL;
-            }
+        if (binario)
+            binario = ES_leDoubles(in, newSL->x, n);
+        else
+            for (unsigned int i=0; i < n && !binario; ++i)
+                binario = ES_leDouble(in, &newSL->x[i]);
+        if (binario) {
+            fputs("Falha de leitura\n", stderr);
+            SL_libera(newSL);
+            return NULL;
         }
     }
 
+    in->tempo += ES_timestamp() - tempo;
     return newSL;
 }
 
 /*!
-  \brief Imprime matriz
+  \brief Le as próximas qtd linhas do conjunto de dados de SL_leituraCabecalho()
 
-  \param matrix matriz a ser impressa
-  \param n número de valores tabelados
-  \param m número de funções tabeladas
+  \param SL o conjunto de dados (n e formato da entrada)
+  \param A destino com espaço para qtd*SL->n valores
+  \param qtd número de linhas
+  \return 0 se sucesso e -1 em caso de falha
 */
-void SL_printMatrix(FILE *f_out, double *matrix, unsigned int n, unsigned int m) {
+int SL_leituraLinhas(t_sist *SL, double *A, unsigned int qtd) {
 
-  fputc('\n', f_out);
-  for (unsigned int i=0; i<m; ++i) {
-      for (unsigned int j=0; j<n; ++j)
-          fprintf(f_out,"%-1.18g ",matrix[n*i+j]);
-      fputc('\n', f_out);
-	}
-  fputc('\n', f_out);
+    t_leitor *in = ES_entrada();
+    if (!in) return -1;
+
+    double tempo = ES_timestamp();
+    int falha = 0;
+
+    if (SL->binario)
+        falha = ES_leDoubles(in, A, (size_t)SL->n*qtd);
+    else
+        for (size_t i=0; i < (size_t)SL->n*qtd && !falha; ++i)
+            falha = ES_leDouble(in, &A[i]);
+    if (falha) fputs("Falha de leitura\n", stderr);
+
+    in->tempo += ES_timestamp() - tempo;
+    return falha ? -1 : 0;
 }
 
 /*!
- * \brief Realiza interpolação na matriz
- *
- * \param SL sistema linear
- * \param Int sistema após interpolação
- * \param row a linha da matriz de entrada
- * \return retorna 0 para sucesso e -1 para falha
- *
- * \note A otimização escolhida foi unroll e jam
- */
-int SL_interpolacao(t_sist *SL, t_sist *Int, unsigned int row) {
+  \brief Le as linhas (SL->A) de um conjunto de dados de SL_leituraCabecalho()
+  \note Se a entrada binária está mapeada em memória, SL->A aponta
+        diretamente para ela, sem cópia
 
-  if (row == 0) {
+  \param SL o conjunto de dados, sem SL->A
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_leituraMatriz(t_sist *SL) {
+
+    if (SL->mapeado) {
+        SL->A = ES_mapeiaDoubles(ES_entrada(), (size_t)SL->n*SL->m);
+        if (!SL->A) {
+            fputs("Entrada binária truncada\n", stderr);
+            return -1;
+        }
+        return 0;
+    }
+
+    // extrai as linhas contendo os elementos da matriz
+    SL->A = SL_alocaMatrix(SL->n, SL->m);
+    if (!SL->A) return -1;
+    return SL_leituraLinhas(SL, SL->A, SL->m);
+}
+
+/*!
+  \brief Le valores de stdin para preencher t_sist
+  \note a leitura é feita em blocos por ES_entrada(), sem scanf(), e o
+        tempo gasto é acumulado no leitor para ES_vazao(). Aceita tanto o
+        formato texto quanto o binário de ES_MAGICA. Se a entrada binária
+        está mapeada em memória, SL->x e SL->A apontam diretamente para
+        ela, sem cópia
+
+  \return ponteiro para t_sist. NULL se houve erro de alocação ou fim da entrada
+*/
+t_sist *SL_leitura() {
+
+    t_sist *newSL = SL_leituraCabecalho();
+    if (!newSL) return NULL;
+
+    if (SL_leituraMatriz(newSL)) {
+        SL_libera(newSL);
+        return NULL;
+    }
+
+    return newSL;
+}
+
+/*!
+  \brief Imprime matriz
+
+  \param matrix matriz a ser impressa
+  \param n número de valores tabelados
+  \param m número de funções tabeladas
+*/
+void SL_printMatrix(FILE *f_out, double *matrix, unsigned int n, unsigned int m) {
+
+  char buf[ES_TAM_DBL+1];
+  size_t len;
+
+  fputc('\n', f_out);
+  for (unsigned int i=0; i<m; ++i) {
+      for (unsigned int j=0; j<n; ++j) {
+          len = ES_formataDouble(buf, matrix[n*i+j]);
+          buf[len++] = ' ';
+          fwrite(buf, 1, len, f_out);
+      }
+      fputc('\n', f_out);
+	}
+  fputc('\n', f_out);
+}
+
+/*!
+  \brief Monta a matriz de Vandermonde n x n (A[i][j] = x_i^j) em ladrilhos
+         de SL_BK_VANDER_LIN pontos por SL_BK_VANDER_COL potências
+
+  \param x os n pontos
+  \param A a matriz
+
+  \note Em cada ladrilho as potências são calculadas transpostas, com os
+        pontos nas pistas dos vetores: cada coluna é um produto elemento a
+        elemento da anterior pelos pontos, sem a dependência serial ao
+        longo da linha, e o ladrilho é então transposto para A. Os blocos
+        de linhas são divididos entre as threads OpenMP com
+        schedule(static), o mesmo de SL_alocaMatrix() no primeiro toque.
+        Cada potência é o mesmo produto x * x^(j-1) de SL_interpolacao(),
+        logo a matriz é idêntica
+*/
+static void vandermondeLadrilhos(const double *x, double *A, unsigned int n) {
+
+  #pragma omp parallel for schedule(static)
+  for (unsigned int i0=0; i0<n; i0 += SL_BK_VANDER_LIN) {
+      const unsigned int R = (n-i0 < SL_BK_VANDER_LIN) ? n-i0 : SL_BK_VANDER_LIN;
+      double T[SL_BK_VANDER_COL][SL_BK_VANDER_LIN];
+      double xs[SL_BK_VANDER_LIN], pot[SL_BK_VANDER_LIN];
+
+      // pistas além de R ficam com 0, e não são copiadas para A
+      for (unsigned int r=0; r<SL_BK_VANDER_LIN; ++r) {
+          xs[r] = (r < R) ? x[i0+r] : 0.0;
+          pot[r] = 1.0;
+      }
+
+      for (unsigned int j0=0; j0<n; j0 += SL_BK_VANDER_COL) {
+          const unsigned int C = (n-j0 < SL_BK_VANDER_COL) ? n-j0 : SL_BK_VANDER_COL;
+
+          for (unsigned int j=0; j<C; ++j)
+              for (unsigned int r=0; r<SL_BK_VANDER_LIN; ++r) {
+                  T[j][r] = pot[r];
+                  pot[r] = xs[r] * pot[r];
+              }
+
+          for (unsigned int r=0; r<R; ++r) {
+              double *linha = A + (size_t)n*(i0+r) + j0;
+              for (unsigned int j=0; j<C; ++j)
+                  linha[j] = T[j][r];
+          }
+      }
+  }
+}
+
+/*!
+ * \brief Realiza interpolação na matriz
+ *
+ * \param SL sistema linear
+ * \param Int sistema após interpolação
+ * \param row a linha da matriz de entrada
+ * \return retorna 0 para sucesso e -1 para falha
+ *
+ * \note A otimização escolhida foi unroll e jam; a partir de SL_MIN_VANDER
+ *       pontos, a matriz é montada em ladrilhos, em paralelo
+ *       (vandermondeLadrilhos())
+ */
+int SL_interpolacao(t_sist *SL, t_sist *Int, unsigned int row) {
+
+  if (row == 0 && Int->n >= SL_MIN_VANDER)
+      vandermondeLadrilhos(SL->x, Int->A, Int->n);
+  else if (row == 0) {
       for (int i=0; i<(Int->n - (Int->n % 8)); i += 8) {
           // NOTA OTIMIZAÇÃO: como qualquer valor elevado a 0 é possível evitar chamadas desnecessárias a pot()
           Int->A[Int->n*i] = Int->A[Int->n*(i+1)] =     \
@@ -280,6 +1163,104 @@ int SL_interpolacao(t_sist *SL, t_sist *Int, unsigned int row) {
   return 0;
 }
 
+/*!
+ * \brief Obtém a ordem de Leja dos pontos de interpolação
+ *
+ * \param x os pontos
+ * \param n número de pontos
+ * \return vetor de n índices, NULL se houve erro de alocação
+ *
+ * \note Cada ponto escolhido maximiza o produto das distâncias aos já
+ *       escolhidos, o que reduz o crescimento das diferenças divididas
+ *       em SL_interpolacao_bp(). Os produtos são normalizados a cada
+ *       passo para evitar underflow
+ */
+int *SL_ordemLeja(const double *x, unsigned int n) {
+
+  int *ordem = SL_alocaMem(n*sizeof(int));
+  double *prod = SL_alocaMem(n*sizeof(double));
+  if (!ordem || !prod) {
+      perror("Falha ao alocar ordem de Leja");
+      SL_liberaMem(ordem);
+      SL_liberaMem(prod);
+      return NULL;
+  }
+
+  unsigned int max = 0;
+  for (unsigned int i=0; i<n; ++i) {
+      ordem[i] = i;
+      prod[i] = 1.0;
+      if (fabs(x[i]) > fabs(x[max])) max = i;
+  }
+
+  int aux;
+  double maior;
+  for (unsigned int k=0; k<n; ++k) {
+      aux = ordem[k];
+      ordem[k] = ordem[max];
+      ordem[max] = aux;
+      trocaElemento(&prod[k], &prod[max]);
+
+      maior = 0.0;
+      max = k+1;
+      for (unsigned int i=k+1; i<n; ++i) {
+          prod[i] *= fabs(x[ordem[i]] - x[ordem[k]]);
+          if (prod[i] > maior) {
+              maior = prod[i];
+              max = i;
+          }
+      }
+      if (maior > 0.0)
+          for (unsigned int i=k+1; i<n; ++i)
+              prod[i] /= maior;
+  }
+
+  SL_liberaMem(prod);
+  return ordem;
+}
+
+/*!
+ * \brief Realiza interpolação de uma linha por Björck-Pereyra
+ *
+ * \param SL sistema linear
+ * \param ordem ordem dos pontos obtida por SL_ordemLeja(), NULL para a
+ *              ordem de entrada
+ * \param row a linha da matriz de entrada
+ * \param pol vetor do polinomio resultante 1xn previamente alocado
+ * \return retorna 0 para sucesso e -1 para falha
+ *
+ * \note Obtém os coeficientes diretamente de SL->x e da linha em O(n²)
+ *       operações e O(n) de memória, sem montar a matriz de Vandermonde:
+ *       as diferenças divididas de Newton são calculadas em pol e depois
+ *       convertidas para a base de monômios
+ */
+int SL_interpolacao_bp(t_sist *SL, const int *ordem, unsigned int row, double *pol) {
+
+#define PONTO(i) (ordem ? SL->x[ordem[i]] : SL->x[i])
+
+  const int n = SL->n;
+  const double *y = SL->A + (size_t)n*row;
+
+  for (int i=0; i<n; ++i)
+      pol[i] = ordem ? y[ordem[i]] : y[i];
+
+  // diferenças divididas
+  for (int k=0; k<n-1; ++k)
+      for (int i=n-1; i>k; --i) {
+          if (PONTO(i) == PONTO(i-k-1)) return -1;
+          pol[i] = (pol[i] - pol[i-1]) / (PONTO(i) - PONTO(i-k-1));
+      }
+
+  // forma de Newton para monômios
+  for (int k=n-2; k>=0; --k)
+      for (int i=k; i<n-1; ++i)
+          pol[i] -= pol[i+1] * PONTO(k);
+
+#undef PONTO
+
+  return 0;
+}
+
 /*!
  * \brief Realiza ajuste de curvas na matriz
  *
@@ -328,6 +1309,176 @@ int SL_ajusteDeCurvas(t_sist *SL, t_sist *Ajc, unsigned int row, double *lookup)
   return 0;
 }
 
+/*!
+ * \brief Realiza ajuste de curvas a partir dos momentos de SL->x
+ *
+ * \param SL sistema linear
+ * \param Ajc sistema linear após ajuste de curvas
+ * \param row a linha da matriz de entrada
+ * \return retorna 0 para sucesso e -1 para falha
+ *
+ * \note A matriz das equações normais é de Hankel, Ajc->A[i][j] = s[i+j]
+ *       com s[k] = Σx^k, então basta obter os 2n-1 momentos em uma única
+ *       passada por SL->x, sem a lookup table n x n. Os pontos são
+ *       processados em blocos de SL_BK_MOM, com as potências de cada bloco
+ *       somadas como uma redução vetorizável
+ */
+int SL_ajusteDeCurvas_momentos(t_sist *SL, t_sist *Ajc, unsigned int row) {
+
+  const unsigned int n = SL->n;
+  double p[SL_BK_MOM], xb[SL_BK_MOM], soma;
+  unsigned int tam;
+
+  if (row == 0) {
+      double *s = SL_alocaMem((2*n-1)*sizeof(double));
+      if (!s) {
+          perror("Falha ao alocar momentos");
+          return -1;
+      }
+
+      for (unsigned int j0=0; j0 < n; j0 += SL_BK_MOM) {
+          tam = (n-j0 < SL_BK_MOM) ? n-j0 : SL_BK_MOM;
+          // pontos ausentes no último bloco não contribuem (p = 0)
+          for (unsigned int c=0; c < SL_BK_MOM; ++c) {
+              p[c] = (c < tam) ? 1.0 : 0.0;
+              xb[c] = (c < tam) ? SL->x[j0+c] : 0.0;
+          }
+          for (unsigned int k=0; k < 2*n-1; ++k) {
+              soma = 0.0;
+              for (unsigned int c=0; c < SL_BK_MOM; ++c) {
+                  soma += p[c];
+                  p[c] *= xb[c];
+              }
+              s[k] += soma;
+          }
+      }
+
+      for (unsigned int i=0; i < n; ++i)
+          memcpy(Ajc->A + (size_t)n*i, s+i, n*sizeof(double));
+
+      SL_liberaMem(s);
+  }
+
+  // B[i] = Σ y*x^i, na mesma passada em blocos
+  const double *y = SL->A + (size_t)n*row;
+  memset(Ajc->B, 0, n*sizeof(double));
+  for (unsigned int j0=0; j0 < n; j0 += SL_BK_MOM) {
+      tam = (n-j0 < SL_BK_MOM) ? n-j0 : SL_BK_MOM;
+      for (unsigned int c=0; c < SL_BK_MOM; ++c) {
+          p[c] = (c < tam) ? y[j0+c] : 0.0;
+          xb[c] = (c < tam) ? SL->x[j0+c] : 0.0;
+      }
+      for (unsigned int i=0; i < n; ++i) {
+          soma = 0.0;
+          for (unsigned int c=0; c < SL_BK_MOM; ++c) {
+              soma += p[c];
+              p[c] *= xb[c];
+          }
+          Ajc->B[i] += soma;
+      }
+  }
+
+  return 0;
+}
+
+/*!
+ * \brief Calcula os termos independentes do ajuste de curvas de todas as
+ *        linhas com um único produto de matrizes
+ *
+ * \param SL sistema linear
+ * \param X matriz n x m de saída, X[i][r] = Σ x^i * SL->A[r], um termo
+ *          independente por coluna (formato de SL_substituicao_lote())
+ * \return retorna 0 para sucesso e -1 para falha
+ *
+ * \note Equivale a X = P * SL->A^T, com P[i][j] = x_j^i. O produto é feito
+ *       em blocos de SL_BK pontos, gerando as potências do bloco sob
+ *       demanda (sem lookup table n x n), e de SL_BK_GEMM linhas de SL->A
+ *       transpostas para um buffer contíguo. A ordem das somas de cada
+ *       elemento é a mesma de SL_ajusteDeCurvas(). Os blocos de linhas são
+ *       divididos entre as threads OpenMP
+ */
+int SL_ajusteDeCurvas_lote(t_sist *SL, double *X) {
+
+  const unsigned int n = SL->n, m = SL->m;
+  int falha = 0;
+
+  // cada thread processa blocos de linhas disjuntos, com P e T próprios
+  #pragma omp parallel reduction(|:falha)
+  {
+    unsigned int kc, mc;
+    double a, *xi;
+
+    double *P = SL_alocaMem((size_t)n*SL_BK*sizeof(double));
+    double *T = SL_alocaMem((size_t)SL_BK*SL_BK_GEMM*sizeof(double));
+    if (!P || !T) {
+        perror("Falha ao alocar blocos do produto");
+        falha = 1;
+    }
+
+    #pragma omp for schedule(static)
+    for (unsigned int r0=0; r0 < m; r0 += SL_BK_GEMM) {
+        if (falha) continue;
+        mc = (m-r0 < SL_BK_GEMM) ? m-r0 : SL_BK_GEMM;
+
+        for (unsigned int i=0; i < n; ++i)
+            memset(X + (size_t)m*i + r0, 0, mc*sizeof(double));
+
+        for (unsigned int j0=0; j0 < n; j0 += SL_BK) {
+            kc = (n-j0 < SL_BK) ? n-j0 : SL_BK;
+
+            // potências dos pontos do bloco, P[i][jj] = x_(j0+jj)^i
+            for (unsigned int jj=0; jj < kc; ++jj)
+                P[jj] = 1.0;
+            for (unsigned int i=1; i < n; ++i)
+                for (unsigned int jj=0; jj < kc; ++jj)
+                    P[kc*i+jj] = P[kc*(i-1)+jj] * SL->x[j0+jj];
+
+            // transpõe o bloco de linhas de SL->A
+            for (unsigned int rr=0; rr < mc; ++rr)
+                for (unsigned int jj=0; jj < kc; ++jj)
+                    T[mc*jj+rr] = SL->A[(size_t)n*(r0+rr)+j0+jj];
+
+            for (unsigned int i=0; i < n; ++i) {
+                xi = X + (size_t)m*i + r0;
+                for (unsigned int jj=0; jj < kc; ++jj) {
+                    a = P[kc*i+jj];
+                    for (unsigned int rr=0; rr < mc; ++rr)
+                        xi[rr] += T[mc*jj+rr] * a;
+                }
+            }
+        }
+    }
+
+    SL_liberaMem(T);
+    SL_liberaMem(P);
+  }
+
+  return falha ? -1 : 0;
+}
+
+/*!
+  \brief Aloca L, U e vetTroca para a fatoração LU
+
+  \param SL o sistema linear
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int alocaFatores(t_sist *SL) {
+
+    if (!SL->L) {
+        SL->L = SL_alocaMatrix(SL->n, SL->n);
+        if (!SL->L) return -1;
+    }
+    SL->U = SL_alocaMatrix(SL->n, SL->n);
+    if (!SL->U) return -1;
+    SL->vetTroca = SL_alocaMem(SL->n*2*sizeof(int));
+    if (!SL->vetTroca) {
+        SL_liberaMem(SL->U);
+        SL->U = NULL;
+        return -1;
+    }
+    return 0;
+}
+
 /*!
   \brief Triangulariza a matriz SL->A de norma n
   \note separa SL->A em L e U
@@ -339,10 +1490,7 @@ int SL_ajusteDeCurvas(t_sist *SL, t_sist *Ajc, unsigned int row, double *lookup)
 int SL_triangulariza_otimiz(t_sist *SL) {
   
     if (!SL->U) {
-      SL->U = SL_alocaMatrix(SL->n, SL->n);
-      if (!SL->U) return -1;
-      SL->vetTroca = calloc(1, SL->n*2*sizeof(int));
-      if (!SL->vetTroca) return -1;
+      if (alocaFatores(SL)) return -1;
     
     memcpy(SL->U, SL->A, SL->n * SL->n * sizeof(double));
 
@@ -365,14 +1513,384 @@ int SL_triangulariza_otimiz(t_sist *SL) {
             m = SL->U[SL->n*j+i] / divi;
             SL->U[SL->n*j+i] = 0.0;
             SL->L[SL->n*j+i] = m;
-            for (int k=i+1; k<SL->n; k++)
-                SL->U[SL->n*j+k] -= SL->U[SL->n*i+k] * m;
+            SIMD_elimina(&SL->U[SL->n*j+i+1], &SL->U[SL->n*i+i+1], m, SL->n-i-1);
         }
     }
     }
     return 0;
 }
 
+/*!
+  \brief Triangulariza a matriz SL->A com o kernel de dimensão fixa de n
+         (DIMENSOES_FIXAS: 4, 8, 10, 16 e 32)
+  \note L, U e vetTroca idênticos aos de SL_triangulariza_otimiz()
+
+  \param SL o sistema linear
+  \return 0 se sucesso, -1 em caso de falha e 1 se não há kernel para n
+*/
+int SL_triangulariza_fixa(t_sist *SL) {
+
+    const t_fixa *fixa = kernelFixo(SL->n);
+    if (!fixa) return 1;
+    if (SL->U) return 0;
+
+    if (alocaFatores(SL)) return -1;
+    memcpy(SL->U, SL->A, SL->n * SL->n * sizeof(double));
+    fixa->triangulariza(SL->U, SL->L, SL->vetTroca);
+    return 0;
+}
+
+/*!
+  \brief Triangulariza a matriz SL->A de norma n por blocos (LU right-looking)
+  \note separa SL->A em L e U, com os mesmos L, U e vetTroca obtidos por
+        SL_triangulariza_otimiz(). Cada painel de bk colunas é fatorado e
+        a submatriz restante é atualizada em ladrilhos de bk colunas, de
+        forma que as linhas do painel em U sejam reaproveitadas na cache
+
+  \param SL o sistema linear
+  \param bk tamanho do bloco (0 utiliza SL_BK)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_triangulariza_blocos(t_sist *SL, unsigned int bk) {
+
+    if (SL->U) return 0;
+
+    if (alocaFatores(SL)) return -1;
+
+    memcpy(SL->U, SL->A, SL->n * SL->n * sizeof(double));
+
+    if (!bk) bk = SL_BK;
+
+    const int n = SL->n;
+    double *U = SL->U, *L = SL->L;
+    int pivo, fim, fimc;
+    double m, divi;
+
+    for (int k=0; k<n; k += bk) {
+        fim = (k+bk < n) ? k+bk : n;
+
+        // fatoração do painel: atualiza apenas as colunas [k, fim)
+        for (int i=k; i<fim; i++) {
+            pivo = maxValue(U,n,i);
+            if (pivo != i) {
+                SL->vetTroca[2*i] = i;
+                SL->vetTroca[2*i+1] = pivo;
+                trocaLinha(U, i, pivo, n);
+                trocaLinha(L, i, pivo, n);
+            }
+
+            divi = U[n*i+i];
+            L[n*i+i] = 1.0;
+            for (int j=i+1; j<n; j++) {
+                m = U[n*j+i] / divi;
+                U[n*j+i] = 0.0;
+                L[n*j+i] = m;
+                SIMD_elimina(&U[n*j+i+1], &U[n*i+i+1], m, fim-i-1);
+            }
+        }
+        if (fim == n) break;
+
+        // linhas do painel à direita dele (U12 = L11^-1 * A12)
+        for (int i=k; i<fim; i++)
+            for (int j=i+1; j<fim; j++) {
+                m = L[n*j+i];
+                SIMD_elimina(&U[n*j+fim], &U[n*i+fim], m, n-fim);
+            }
+
+        // atualização da submatriz restante (A22 -= L21 * U12) em ladrilhos
+        // de colunas, mantendo a ordem das subtrações de cada elemento
+        for (int cc=fim; cc<n; cc += bk) {
+            fimc = (cc+bk < n) ? cc+bk : n;
+            for (int j=fim; j<n; j++)
+                for (int i=k; i<fim; i++) {
+                    m = L[n*j+i];
+                    SIMD_elimina(&U[n*j+cc], &U[n*i+cc], m, fimc-cc);
+                }
+        }
+    }
+    return 0;
+}
+
+/*!
+  \brief Triangulariza a matriz SL->A de norma n guardando L e U em um
+         único arranjo n x n (SL->LU) e a permutação em n inteiros (SL->piv)
+  \note L fica abaixo da diagonal, com a diagonal unitária implícita, e U
+        no triângulo superior. Com SL->emLugar, SL->A é sobrescrita pelos
+        fatores e nenhuma matriz é alocada; se não, o espaço reservado em
+        SL->LUd e um SL->piv já existente (de SL_LU_MISTA) são usados. As operações são as mesmas de
+        SL_triangulariza_blocos() (ou SL_triangulariza_otimiz() se bk = 0),
+        de forma que as soluções são idênticas
+
+  \param SL o sistema linear
+  \param bk tamanho do bloco (0: sem blocos)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_triangulariza_compacta(t_sist *SL, unsigned int bk) {
+
+    if (SL->LU) return 0;
+
+    const int n = SL->n;
+    double *LU;
+
+    if (!SL->piv) SL->piv = SL_alocaMem(n*sizeof(int));
+    if (!SL->piv) {
+        perror("Falha ao alocar vetor de permutação");
+        return -1;
+    }
+
+    if (SL->emLugar && !SL->mapeado)
+        LU = SL->A;
+    else if (SL->LUd) {
+        LU = SL->LUd;
+        SL->LUd = NULL;
+        memcpy(LU, SL->A, (size_t)n*n*sizeof(double));
+    } else {
+        LU = SL_alocaMatrix(n, n);
+        if (!LU) {
+            SL_liberaMem(SL->piv);
+            SL->piv = NULL;
+            return -1;
+        }
+        memcpy(LU, SL->A, (size_t)n*n*sizeof(double));
+    }
+
+    // sem blocos, o painel é a matriz inteira
+    if (!bk || bk > n) bk = n;
+
+    int pivo, fim, fimc;
+    double m, divi;
+
+    for (int k=0; k<n; k += bk) {
+        fim = (k+bk < n) ? k+bk : n;
+
+        // fatoração do painel: atualiza apenas as colunas [k, fim)
+        for (int i=k; i<fim; i++) {
+            pivo = maxValue(LU,n,i);
+            SL->piv[i] = pivo;
+            if (pivo != i)
+                trocaLinha(LU, i, pivo, n);
+
+            divi = LU[n*i+i];
+            for (int j=i+1; j<n; j++) {
+                m = LU[n*j+i] / divi;
+                LU[n*j+i] = m;
+                SIMD_elimina(&LU[n*j+i+1], &LU[n*i+i+1], m, fim-i-1);
+            }
+        }
+        if (fim == n) break;
+
+        // linhas do painel à direita dele (U12 = L11^-1 * A12)
+        for (int i=k; i<fim; i++)
+            for (int j=i+1; j<fim; j++) {
+                m = LU[n*j+i];
+                SIMD_elimina(&LU[n*j+fim], &LU[n*i+fim], m, n-fim);
+            }
+
+        // atualização da submatriz restante (A22 -= L21 * U12)
+        for (int cc=fim; cc<n; cc += bk) {
+            fimc = (cc+bk < n) ? cc+bk : n;
+            for (int j=fim; j<n; j++)
+                for (int i=k; i<fim; i++) {
+                    m = LU[n*j+i];
+                    SIMD_elimina(&LU[n*j+cc], &LU[n*i+cc], m, fimc-cc);
+                }
+        }
+    }
+
+    SL->LU = LU;
+    return 0;
+}
+
+/*!
+  \brief Triangulariza SL->A como SL_triangulariza_compacta(), mas com os
+         fatores em precisão simples (SL->LUf e SL->piv)
+  \note metade da banda de memória e o dobro de elementos por vetor em
+        relação à LU em double. SL->A é preservada, pois o refinamento
+        iterativo de SL_substituicao_lote() calcula os resíduos com ela
+
+  \param SL o sistema linear
+  \param bk tamanho do bloco (0: sem blocos)
+  \return 0 se sucesso, 1 se A não é representável em float ou um pivô
+          se anulou (use a LU em double) e -1 em caso de falha
+*/
+int SL_triangulariza_mista(t_sist *SL, unsigned int bk) {
+
+    if (SL->LUf) return 0;
+
+    const int n = SL->n;
+    float *LU = SL_alocaMem((size_t)n*n*sizeof(float));
+    int *piv = SL_alocaMem(n*sizeof(int));
+    if (!LU || !piv) {
+        perror("Falha ao alocar fatores em precisão simples");
+        SL_liberaMem(LU);
+        SL_liberaMem(piv);
+        return -1;
+    }
+
+    for (size_t k=0; k<(size_t)n*n; ++k) {
+        LU[k] = (float) SL->A[k];
+        if (!isfinite(LU[k])) {
+            SL_liberaMem(LU);
+            SL_liberaMem(piv);
+            return 1;
+        }
+    }
+
+    if (!bk || bk > n) bk = n;
+
+    int pivo, fim, fimc;
+    float m, divi, aux;
+
+    for (int k=0; k<n; k += bk) {
+        fim = (k+bk < n) ? k+bk : n;
+
+        for (int i=k; i<fim; i++) {
+            pivo = i;
+            for (int j=i+1; j<n; j++)
+                if (fabsf(LU[(size_t)n*j+i]) > fabsf(LU[(size_t)n*pivo+i]))
+                    pivo = j;
+            piv[i] = pivo;
+            if (pivo != i)
+                for (int j=0; j<n; j++) {
+                    aux = LU[(size_t)n*i+j];
+                    LU[(size_t)n*i+j] = LU[(size_t)n*pivo+j];
+                    LU[(size_t)n*pivo+j] = aux;
+                }
+
+            divi = LU[(size_t)n*i+i];
+            if (divi == 0.0f || !isfinite(divi)) {
+                SL_liberaMem(LU);
+                SL_liberaMem(piv);
+                return 1;
+            }
+            for (int j=i+1; j<n; j++) {
+                m = LU[(size_t)n*j+i] / divi;
+                LU[(size_t)n*j+i] = m;
+                SIMD_eliminaf(&LU[(size_t)n*j+i+1], &LU[(size_t)n*i+i+1], m, fim-i-1);
+            }
+        }
+        if (fim == n) break;
+
+        for (int i=k; i<fim; i++)
+            for (int j=i+1; j<fim; j++)
+                SIMD_eliminaf(&LU[(size_t)n*j+fim], &LU[(size_t)n*i+fim], LU[(size_t)n*j+i], n-fim);
+
+        for (int cc=fim; cc<n; cc += bk) {
+            fimc = (cc+bk < n) ? cc+bk : n;
+            for (int j=fim; j<n; j++)
+                for (int i=k; i<fim; i++)
+                    SIMD_eliminaf(&LU[(size_t)n*j+cc], &LU[(size_t)n*i+cc], LU[(size_t)n*j+i], fimc-cc);
+        }
+    }
+
+    SL->LUf = LU;
+    SL->piv = piv;
+    return 0;
+}
+
+/*!
+  \brief Busca do pivô da coluna j entre as linhas lógicas j..n-1
+*/
+static unsigned int maxIndireto(const double *LU, const int *perm, unsigned int n, unsigned int j) {
+
+    unsigned int max = j;
+
+    for (unsigned int i=j+1; i<n; i++)
+        if (fabs(LU[(size_t)n*perm[i]+j]) > fabs(LU[(size_t)n*perm[max]+j]))
+            max = i;
+    return max;
+}
+
+/*!
+  \brief Triangulariza a matriz SL->A de norma n como
+         SL_triangulariza_compacta(), sem mover linhas: o pivoteamento só
+         troca entradas da permutação SL->perm (a linha lógica i de SL->LU
+         é a linha física perm[i])
+  \note troca de linhas em O(1) em vez de O(n) leituras e escritas; os
+        fatores e as soluções são idênticos aos das demais variantes
+
+  \param SL o sistema linear
+  \param bk tamanho do bloco (0: sem blocos)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_triangulariza_indireta(t_sist *SL, unsigned int bk) {
+
+    if (SL->LU) return 0;
+
+    const int n = SL->n;
+    double *LU, *ri, *rj;
+    int *perm;
+
+    perm = SL_alocaMem(n*sizeof(int));
+    if (!perm) {
+        perror("Falha ao alocar vetor de permutação");
+        return -1;
+    }
+    for (int i=0; i<n; ++i)
+        perm[i] = i;
+
+    if (SL->emLugar && !SL->mapeado)
+        LU = SL->A;
+    else {
+        LU = SL_alocaMatrix(n, n);
+        if (!LU) {
+            SL_liberaMem(perm);
+            return -1;
+        }
+        memcpy(LU, SL->A, (size_t)n*n*sizeof(double));
+    }
+
+    if (!bk || bk > n) bk = n;
+
+    int pivo, fim, fimc, aux;
+    double m, divi;
+
+    for (int k=0; k<n; k += bk) {
+        fim = (k+bk < n) ? k+bk : n;
+
+        // fatoração do painel: atualiza apenas as colunas [k, fim)
+        for (int i=k; i<fim; i++) {
+            pivo = maxIndireto(LU, perm, n, i);
+            aux = perm[i];
+            perm[i] = perm[pivo];
+            perm[pivo] = aux;
+
+            ri = LU + (size_t)n*perm[i];
+            divi = ri[i];
+            for (int j=i+1; j<n; j++) {
+                rj = LU + (size_t)n*perm[j];
+                m = rj[i] / divi;
+                rj[i] = m;
+                SIMD_elimina(rj+i+1, ri+i+1, m, fim-i-1);
+            }
+        }
+        if (fim == n) break;
+
+        // linhas do painel à direita dele (U12 = L11^-1 * A12)
+        for (int i=k; i<fim; i++) {
+            ri = LU + (size_t)n*perm[i];
+            for (int j=i+1; j<fim; j++) {
+                rj = LU + (size_t)n*perm[j];
+                SIMD_elimina(rj+fim, ri+fim, rj[i], n-fim);
+            }
+        }
+
+        // atualização da submatriz restante (A22 -= L21 * U12)
+        for (int cc=fim; cc<n; cc += bk) {
+            fimc = (cc+bk < n) ? cc+bk : n;
+            for (int j=fim; j<n; j++) {
+                rj = LU + (size_t)n*perm[j];
+                for (int i=k; i<fim; i++)
+                    SIMD_elimina(rj+cc, LU + (size_t)n*perm[i] + cc, rj[i], fimc-cc);
+            }
+        }
+    }
+
+    SL->LU = LU;
+    SL->perm = perm;
+    return 0;
+}
+
 /*!
   \brief Triangulariza a matriz SL->A de norma n
   \note separa SL->A em L e U
@@ -382,7 +1900,13 @@ int SL_triangulariza_otimiz(t_sist *SL) {
 */
 int SL_triangulariza(t_sist *SL) {
   
-    double *copia = SL_alocaMatrix(SL->n, SL->n);
+    if (!SL->L) {
+        SL->L = SL_alocaMatrix(SL->n, SL->n);
+        if (!SL->L) return -1;
+    }
+
+    // reaproveita U de uma fatoração anterior
+    double *copia = SL->U ? SL->U : SL_alocaMatrix(SL->n, SL->n);
     if (!copia) return -1;
     memcpy(copia, SL->A, SL->n * SL->n * sizeof(double));
     
@@ -402,13 +1926,696 @@ int SL_triangulariza(t_sist *SL) {
             double m = copia[SL->n*j+i] / copia[SL->n*i+i];
             copia[SL->n*j+i] = 0.0;
             SL->L[SL->n*j+i] = m;
-            for (int k=i+1; k<SL->n; k++)
-                copia[SL->n*j+k] -= copia[SL->n*i+k] * m;
+            SIMD_elimina(&copia[SL->n*j+i+1], &copia[SL->n*i+i+1], m, SL->n-i-1);
         }
     }
 
-    if (SL->U) free(SL->U);
     SL->U = copia;
 
     return 0;
 }
+
+/*!
+  \brief Fatoração de Cholesky (A = L*L^T) da matriz simétrica SL->A
+  \note apenas o triângulo inferior de SL->A é lido. L é guardado em
+        SL->C, compactado por linhas: L[i][j] (j <= i) em C[i*(i+1)/2 + j],
+        n(n+1)/2 elementos, sem L, U e vetTroca
+
+  \param SL o sistema linear
+  \return 0 se sucesso, 1 se SL->A não é definida positiva e -1 em caso
+          de falha de alocação
+*/
+int SL_cholesky(t_sist *SL) {
+
+    if (SL->C) return 0;
+
+    const int n = SL->n;
+    double *C = SL_alocaMem((size_t)n*(n+1)/2 * sizeof(double));
+    if (!C) {
+        perror("Falha ao alocar matriz");
+        return -1;
+    }
+
+    double *ci, *cj, soma;
+
+    for (int i=0; i<n; ++i) {
+        ci = C + (size_t)i*(i+1)/2;
+        for (int j=0; j<=i; ++j) {
+            cj = C + (size_t)j*(j+1)/2;
+            // linhas i e j de L são contíguas no formato compactado
+            soma = SL->A[(size_t)n*i+j];
+            for (int k=0; k<j; ++k)
+                soma -= ci[k] * cj[k];
+
+            if (j < i)
+                ci[j] = soma / cj[j];
+            else if (soma > 0.0 && isfinite(soma))
+                ci[i] = sqrt(soma);
+            else {
+                SL_liberaMem(C);
+                return 1;
+            }
+        }
+    }
+
+    SL->C = C;
+    return 0;
+}
+
+/*!
+  \brief Descarta os fatores de SL (exceto o de Cholesky), que deixam de
+         valer quando SL->A muda. O próximo SL_fatoracao() refatora
+*/
+static void descartaFatores(t_sist *SL) {
+
+    SL_liberaMem(SL->L);
+    SL_liberaMem(SL->U);
+    SL_liberaMem(SL->vetTroca);
+    SL_liberaMem(SL->LU);
+    SL_liberaMem(SL->piv);
+    SL_liberaMem(SL->perm);
+    SL_liberaMem(SL->LUf);
+    SL_liberaMem(SL->LUd);
+    SL->L = SL->U = SL->LU = SL->LUd = NULL;
+    SL->LUf = NULL;
+    SL->vetTroca = SL->piv = SL->perm = NULL;
+}
+
+/*!
+  \brief Inclui (sinal = 1) ou remove (sinal = -1) o ponto x do ajuste de
+         curvas, com uma atualização de posto 1 das equações normais e do
+         fator de Cholesky em O(n²)
+
+  \param Ajc sistema do ajuste de curvas (n x n)
+  \param x o ponto
+  \param y valor de cada uma das m linhas em x
+  \param B termos independentes n x m, um por coluna (formato de
+           SL_ajusteDeCurvas_lote())
+  \param sinal 1 ou -1
+  \return 0 se sucesso, 1 se a remoção deixou Ajc->A não definida positiva
+          (Ajc->C é descartado) e -1 em caso de falha
+*/
+static int atualizaPonto(t_sist *Ajc, double x, const double *y, double *B,
+                         unsigned int m, double sinal) {
+
+    const unsigned int n = Ajc->n;
+
+    if (Ajc->metodo == SL_QR || Ajc->QR) {
+        fputs("Atualização incremental: use SL_CHOLESKY ou LU, não QR\n", stderr);
+        return -1;
+    }
+    if (Ajc->LU && Ajc->LU == Ajc->A) {
+        fputs("Atualização incremental: A foi sobrescrita pela LU compacta\n", stderr);
+        return -1;
+    }
+
+    double *p = SL_alocaMem(2*(size_t)n*sizeof(double));
+    if (!p) {
+        perror("Falha ao alocar vetor de potências");
+        return -1;
+    }
+    double *w = p + n;
+
+    // p[i] = x^i; A += sinal * p p^T e B[i][r] += sinal * y[r] * x^i
+    p[0] = 1.0;
+    for (unsigned int i=1; i<n; ++i)
+        p[i] = p[i-1] * x;
+    for (unsigned int i=0; i<n; ++i) {
+        SIMD_elimina(Ajc->A + (size_t)n*i, p, -sinal*p[i], n);
+        SIMD_elimina(B + (size_t)m*i, y, -sinal*p[i], m);
+    }
+
+    descartaFatores(Ajc);
+    if (!Ajc->C) {
+        SL_liberaMem(p);
+        return 0;
+    }
+
+    /*
+     * L L^T + sinal * p p^T = L' L'^T, uma coluna de L por vez com rotações
+     * (inclusão) ou rotações hiperbólicas (remoção), como em dchud/dchdd do
+     * LINPACK. L[i][k] está em C[i*(i+1)/2 + k]
+     */
+    double *C = Ajc->C, r, c, s, lkk, lik;
+    int ret = 0;
+
+    memcpy(w, p, n*sizeof(double));
+    for (unsigned int k=0; k<n; ++k) {
+        lkk = C[(size_t)k*(k+1)/2 + k];
+        r = lkk*lkk + sinal * w[k]*w[k];
+        if (!(r > 0.0) || !isfinite(r)) {
+            ret = 1;
+            break;
+        }
+        r = sqrt(r);
+        c = r / lkk;
+        s = w[k] / lkk;
+        C[(size_t)k*(k+1)/2 + k] = r;
+        for (unsigned int i=k+1; i<n; ++i) {
+            lik = (C[(size_t)i*(i+1)/2 + k] + sinal * s * w[i]) / c;
+            C[(size_t)i*(i+1)/2 + k] = lik;
+            w[i] = c * w[i] - s * lik;
+        }
+    }
+
+    if (ret) {
+        SL_liberaMem(Ajc->C);
+        Ajc->C = NULL;
+    }
+    SL_liberaMem(p);
+    return ret;
+}
+
+/*!
+  \brief Acrescenta o ponto (x, y) ao ajuste de curvas já montado, sem
+         refazer as somas nem a fatoração
+  \note Ajc->A recebe p p^T, p = (1, x, ..., x^(n-1)), e, se Ajc já foi
+        fatorado por Cholesky, Ajc->C recebe a atualização de posto 1,
+        em O(n²) em vez de O(n³). Fatores LU são descartados e refeitos no
+        próximo SL_fatoracao(). Depois, basta resolver uma cópia de B com
+        SL_substituicao_lote()
+
+  \param Ajc sistema do ajuste de curvas
+  \param x o novo ponto
+  \param y valor de cada uma das m linhas no novo ponto
+  \param B termos independentes n x m (Σ y x^i), um por coluna
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_ajusteInclui(t_sist *Ajc, double x, const double *y, double *B, unsigned int m) {
+    return atualizaPonto(Ajc, x, y, B, m, 1.0);
+}
+
+/*!
+  \brief Retira o ponto (x, y) do ajuste de curvas, como SL_ajusteInclui()
+         com a remoção de posto 1 do fator de Cholesky
+
+  \param Ajc sistema do ajuste de curvas
+  \param x o ponto retirado
+  \param y valor de cada uma das m linhas no ponto retirado
+  \param B termos independentes n x m (Σ y x^i), um por coluna
+  \return 0 se sucesso, 1 se Ajc->A deixou de ser definida positiva (o
+          fator é descartado e SL_fatoracao() recorre à LU) e -1 em caso de
+          falha
+*/
+int SL_ajusteRemove(t_sist *Ajc, double x, const double *y, double *B, unsigned int m) {
+    return atualizaPonto(Ajc, x, y, B, m, -1.0);
+}
+
+/*!
+  \brief Fatoração QR de Householder da matriz SL->A com SL->m linhas e
+         SL->n colunas (SL->m >= SL->n), sem formar as equações normais
+  \note SL->QR guarda R no triângulo superior e, abaixo da diagonal, os
+        vetores de Householder v_j (v_j[j] = 1 implícito), como em dgeqrf.
+        Q = H_0 H_1 ... H_(n-1), H_j = I - tau_j v_j v_j^T
+
+  \param SL o sistema linear
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_qr(t_sist *SL) {
+
+    if (SL->QR) return 0;
+
+    const unsigned int n = SL->n, p = SL->m;
+    if (p < n) {
+        fputs("QR: o sistema deve ter ao menos tantas linhas quanto colunas\n", stderr);
+        return -1;
+    }
+
+    double *QR = SL_alocaMatrix(p, n);
+    double *tau = SL_alocaMatrix(1, n);
+    double *w = SL_alocaMatrix(1, n);
+    if (!QR || !tau || !w) {
+        SL_liberaMem(QR);
+        SL_liberaMem(tau);
+        SL_liberaMem(w);
+        return -1;
+    }
+    memcpy(QR, SL->A, (size_t)p*n*sizeof(double));
+
+    double alfa, beta, norma, escala, *qi;
+
+    for (unsigned int j=0; j < n; ++j) {
+        // reflexão que anula a coluna j abaixo da diagonal
+        alfa = QR[(size_t)n*j+j];
+        norma = 0.0;
+        for (unsigned int i=j+1; i < p; ++i)
+            norma += QR[(size_t)n*i+j] * QR[(size_t)n*i+j];
+        if (norma == 0.0) {
+            tau[j] = 0.0;
+            continue;
+        }
+        beta = -copysign(sqrt(alfa*alfa + norma), alfa);
+        tau[j] = (beta - alfa) / beta;
+        escala = 1.0 / (alfa - beta);
+        for (unsigned int i=j+1; i < p; ++i)
+            QR[(size_t)n*i+j] *= escala;
+        QR[(size_t)n*j+j] = beta;
+
+        // aplica H_j às colunas seguintes percorrendo QR por linhas:
+        // w = v_j^T * QR[j:p, j+1:n] e QR[j:p, j+1:n] -= tau_j * v_j * w
+        memcpy(w+j+1, QR + (size_t)n*j+j+1, (n-j-1)*sizeof(double));
+        for (unsigned int i=j+1; i < p; ++i) {
+            qi = QR + (size_t)n*i;
+            for (unsigned int k=j+1; k < n; ++k)
+                w[k] += qi[j] * qi[k];
+        }
+        for (unsigned int k=j+1; k < n; ++k)
+            w[k] *= tau[j];
+        for (unsigned int k=j+1; k < n; ++k)
+            QR[(size_t)n*j+k] -= w[k];
+        for (unsigned int i=j+1; i < p; ++i) {
+            qi = QR + (size_t)n*i;
+            for (unsigned int k=j+1; k < n; ++k)
+                qi[k] -= qi[j] * w[k];
+        }
+    }
+
+    SL_liberaMem(w);
+    SL->QR = QR;
+    SL->tau = tau;
+    return 0;
+}
+
+/*!
+  \brief Mínimos quadrados por QR para múltiplos termos independentes:
+         minimiza ||SL->A * x - y|| para cada linha y de Y
+
+  \param SL o sistema linear fatorado por SL_qr()
+  \param Y matriz m x SL->m com um termo independente por linha (como as
+           linhas do conjunto de dados)
+  \param X matriz SL->n x m que recebe uma solução por coluna
+  \param m número de termos independentes
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note Os termos independentes são transpostos em blocos de SL_BK_LOTE
+        colunas e Q^T é aplicado a todo o bloco de uma vez, reflexão a
+        reflexão, seguido da retrossubstituição com R. Os blocos são
+        independentes e divididos entre as threads OpenMP
+*/
+int SL_qr_lote(t_sist *SL, const double *Y, double *X, unsigned int m) {
+
+  const unsigned int n = SL->n, p = SL->m;
+  int falha = 0;
+
+  SL->reusos += m;
+
+  #pragma omp parallel reduction(|:falha)
+  {
+    unsigned int mc;
+    double *wi, *wj, *xi, t;
+
+    double *W = SL_alocaMem((size_t)p*SL_BK_LOTE*sizeof(double));
+    double *v = SL_alocaMem(SL_BK_LOTE*sizeof(double));
+    if (!W || !v) {
+        perror("Falha ao alocar bloco de termos independentes");
+        falha = 1;
+    }
+
+    #pragma omp for schedule(static)
+    for (unsigned int c0=0; c0 < m; c0 += SL_BK_LOTE) {
+        if (falha) continue;
+        mc = (m-c0 < SL_BK_LOTE) ? m-c0 : SL_BK_LOTE;
+
+        for (unsigned int i=0; i < p; ++i)
+            for (unsigned int c=0; c < mc; ++c)
+                W[mc*i+c] = Y[(size_t)p*(c0+c)+i];
+
+        // W = Q^T * W
+        for (unsigned int j=0; j < n; ++j) {
+            if (SL->tau[j] == 0.0) continue;
+            wj = W + (size_t)mc*j;
+            memcpy(v, wj, mc*sizeof(double));
+            for (unsigned int i=j+1; i < p; ++i) {
+                wi = W + (size_t)mc*i;
+                t = SL->QR[(size_t)n*i+j];
+                for (unsigned int c=0; c < mc; ++c)
+                    v[c] += t * wi[c];
+            }
+            for (unsigned int c=0; c < mc; ++c) {
+                v[c] *= SL->tau[j];
+                wj[c] -= v[c];
+            }
+            for (unsigned int i=j+1; i < p; ++i) {
+                wi = W + (size_t)mc*i;
+                t = SL->QR[(size_t)n*i+j];
+                for (unsigned int c=0; c < mc; ++c)
+                    wi[c] -= t * v[c];
+            }
+        }
+
+        // R * x = (Q^T * y)[0:n]
+        for (int i=n-1; i >= 0; --i) {
+            wi = W + (size_t)mc*i;
+            for (unsigned int j=i+1; j < n; ++j) {
+                wj = W + (size_t)mc*j;
+                t = SL->QR[(size_t)n*i+j];
+                for (unsigned int c=0; c < mc; ++c)
+                    wi[c] -= t * wj[c];
+            }
+            t = SL->QR[(size_t)n*i+i];
+            xi = X + (size_t)m*i + c0;
+            for (unsigned int c=0; c < mc; ++c)
+                xi[c] = wi[c] /= t;
+        }
+    }
+
+    SL_liberaMem(v);
+    SL_liberaMem(W);
+  }
+
+  return falha ? -1 : 0;
+}
+
+/*!
+  \brief Etapa de fatoração: separa SL->A em L e U uma única vez
+  \note chamadas subsequentes reaproveitam os fatores já obtidos, cada
+        termo independente resolvido com eles é contado em SL->reusos.
+        Com SL->metodo == SL_CHOLESKY, se SL->A não for definida positiva
+        SL->metodo volta a SL_LU e a fatoração LU é utilizada. Com
+        SL_QR, os termos independentes são resolvidos por SL_qr_lote().
+        Com SL_LU_MISTA, a LU é feita em float e refinada em double a
+        cada substituição; SL->metodo passa a SL_LU_COMPACTA se os
+        fatores em float não existem ou não levam à convergência. O
+        espaço da LU em double é reservado aqui (SL->LUd), de forma que
+        SL_substituicao_lote() recorra a ela sem alocar fatores.
+        Com SL_LU sem blocos, dimensões com kernel fixo usam
+        SL_triangulariza_fixa()
+
+  \param SL o sistema linear, com SL->bk indicando o tamanho do bloco
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_fatoracao(t_sist *SL) {
+
+    if (SL->U || SL->C || SL->QR || SL->LU || SL->LUf) return 0;
+
+    ++SL->fatoracoes;
+    if (SL->metodo == SL_QR)
+        return SL_qr(SL);
+    if (SL->metodo == SL_LU_COMPACTA)
+        return SL_triangulariza_compacta(SL, SL->bk);
+    if (SL->metodo == SL_LU_INDIRETA)
+        return SL_triangulariza_indireta(SL, SL->bk);
+    if (SL->metodo == SL_LU_MISTA) {
+        int ret = SL_triangulariza_mista(SL, SL->bk);
+        if (ret < 0) return ret;
+        if (!ret) {
+            if (SL->emLugar && !SL->mapeado) return 0;
+            SL->LUd = reservaMem((size_t)SL->n*SL->n*sizeof(double));
+            if (!SL->LUd) perror("Falha ao reservar a LU em double");
+            return SL->LUd ? 0 : -1;
+        }
+        SL->metodo = SL_LU_COMPACTA;
+        return SL_triangulariza_compacta(SL, SL->bk);
+    }
+    if (SL->metodo == SL_CHOLESKY) {
+        int ret = SL_cholesky(SL);
+        if (ret <= 0) return ret;
+        SL->metodo = SL_LU;
+    }
+    if (SL->bk)
+        return SL_triangulariza_blocos(SL, SL->bk);
+    int ret = SL_triangulariza_fixa(SL);
+    if (ret <= 0) return ret;
+    return SL_triangulariza_otimiz(SL);
+}
+
+/*!
+  \brief LU com pivoteamento parcial de SIMD_PISTAS sistemas n x n
+         intercalados, um por pista: o elemento (i, j) do sistema p está em
+         M[SIMD_PISTAS*(n*i+j) + p]
+  \note as mesmas operações, na mesma ordem, de SL_triangulariza_otimiz()
+        em cada pista; só a eliminação, que domina o custo, usa
+        SIMD_eliminaPistas(), os laços sobre as pistas ficam com o compilador
+
+  \param U as matrizes, sobrescritas pelos fatores U
+  \param L fatores L, zerados na entrada
+  \param piv linha trocada com a linha i na etapa i, piv[SIMD_PISTAS*i + p]
+  \param n dimensão dos sistemas
+*/
+static void fatoraPistas(double *U, double *L, int *piv, int n) {
+
+    const int P = SIMD_PISTAS;
+    // cópias locais das pistas, sem aliasing com U e L, para que o
+    // compilador vetorize os laços sobre p
+    double melhor[SIMD_PISTAS], d[SIMD_PISTAS], m[SIMD_PISTAS], v;
+    int ip[SIMD_PISTAS];
+
+    for (int i=0; i<n; ++i) {
+        const double *uii = U + (size_t)P*(n*i+i);
+
+        // pivô de cada pista: o primeiro maior |U[j][i]|, j >= i
+        for (int p=0; p<P; ++p) {
+            ip[p] = i;
+            melhor[p] = fabs(uii[p]);
+        }
+        for (int j=i+1; j<n; ++j) {
+            const double *uji = U + (size_t)P*(n*j+i);
+            for (int p=0; p<P; ++p) {
+                v = fabs(uji[p]);
+                ip[p] = (v > melhor[p]) ? j : ip[p];
+                melhor[p] = (v > melhor[p]) ? v : melhor[p];
+            }
+        }
+        memcpy(piv + (size_t)P*i, ip, sizeof(ip));
+
+        // nas linhas i e ip[p] de U, as colunas < i já são nulas, e as de L
+        // a partir de i ainda não foram preenchidas: basta trocar o resto
+        for (int p=0; p<P; ++p) {
+            if (ip[p] == i) continue;
+            double *a = U + (size_t)P*n*i + p, *b = U + (size_t)P*n*ip[p] + p;
+            double *c = L + (size_t)P*n*i + p, *e = L + (size_t)P*n*ip[p] + p;
+            for (int j=i; j<n; ++j) {
+                v = a[P*j]; a[P*j] = b[P*j]; b[P*j] = v;
+            }
+            for (int j=0; j<i; ++j) {
+                v = c[P*j]; c[P*j] = e[P*j]; e[P*j] = v;
+            }
+        }
+
+        memcpy(d, uii, sizeof(d));
+        for (int p=0; p<P; ++p)
+            L[(size_t)P*(n*i+i) + p] = 1.0;
+        for (int j=i+1; j<n; ++j) {
+            double *uji = U + (size_t)P*(n*j+i);
+            for (int p=0; p<P; ++p)
+                m[p] = uji[p] / d[p];
+            memset(uji, 0, sizeof(m));
+            memcpy(L + (size_t)P*(n*j+i), m, sizeof(m));
+            SIMD_eliminaPistas(uji + P, uii + P, m, n-i-1);
+        }
+    }
+}
+
+/*!
+  \brief Substituição dos SIMD_PISTAS sistemas fatorados por fatoraPistas()
+  \note as mesmas operações, na mesma ordem, de SL_substituicao()
+
+  \param b termos independentes intercalados (b[SIMD_PISTAS*i + p]),
+           sobrescritos pelas soluções
+*/
+static void substituiPistas(const double *U, const double *L, const int *piv, int n, double *b) {
+
+    const int P = SIMD_PISTAS;
+    double acc[SIMD_PISTAS], v;
+
+    for (int i=0; i<n; ++i)
+        for (int p=0; p<P; ++p) {
+            int k = piv[P*i+p];
+            v = b[P*i+p]; b[P*i+p] = b[P*k+p]; b[P*k+p] = v;
+        }
+
+    for (int i=0; i<n; ++i) {
+        memcpy(acc, b + P*i, sizeof(acc));
+        for (int j=i-1; j>=0; --j) {
+            const double *lij = L + (size_t)P*(n*i+j), *bj = b + P*j;
+            for (int p=0; p<P; ++p)
+                acc[p] -= lij[p] * bj[p];
+        }
+        for (int p=0; p<P; ++p)
+            b[P*i+p] = acc[p] / L[(size_t)P*(n*i+i) + p];
+    }
+    for (int i=n-1; i>=0; --i) {
+        memcpy(acc, b + P*i, sizeof(acc));
+        for (int j=i+1; j<n; ++j) {
+            const double *uij = U + (size_t)P*(n*i+j), *bj = b + P*j;
+            for (int p=0; p<P; ++p)
+                acc[p] -= uij[p] * bj[p];
+        }
+        for (int p=0; p<P; ++p)
+            b[P*i+p] = acc[p] / U[(size_t)P*(n*i+i) + p];
+    }
+}
+
+/*!
+  \brief Fatora, e opcionalmente resolve, grupos de SIMD_PISTAS sistemas
+         intercalados; as pistas que sobram no último grupo recebem a
+         identidade
+
+  \param S os sistemas, todos de dimensão n
+  \param pol se não NULL, recebe em pol[k] a solução de S[k] com S[k]->B
+  \param guarda copia L, U e vetTroca de volta para cada sistema
+  \return 0 se sucesso e -1 em caso de falha
+*/
+static int intercalado(t_sist **S, unsigned int qtd, double **pol, _Bool guarda) {
+
+  const int P = SIMD_PISTAS;
+  const int n = S[0]->n;
+  const size_t nn = (size_t)n*n;
+  const unsigned int grupos = (qtd + P - 1) / P;
+  int falha = 0;
+
+  for (unsigned int k=1; k<qtd; ++k)
+      if (S[k]->n != (unsigned int) n) {
+          fputs("Sistemas intercalados de dimensões diferentes\n", stderr);
+          return -1;
+      }
+
+  #pragma omp parallel reduction(|:falha)
+  {
+    double *U = SL_alocaMem((2*nn + n) * P * sizeof(double));
+    int *piv = SL_alocaMem((size_t)n * P * sizeof(int));
+    if (!U || !piv) {
+        perror("Falha ao alocar sistemas intercalados");
+        falha = 1;
+    }
+    double *L = U + nn*P, *b = L + nn*P;
+
+    #pragma omp for schedule(static)
+    for (unsigned int g=0; g<grupos; ++g) {
+        if (falha) continue;
+        t_sist **G = S + (size_t)g*P;
+        const int qg = (qtd - g*P < (unsigned int) P) ? (int)(qtd - g*P) : P;
+
+        for (size_t e=0; e<nn; ++e)
+            for (int p=0; p<P; ++p)
+                U[P*e+p] = (p < qg) ? G[p]->A[e] : (e % (n+1) == 0);
+        memset(L, 0, nn*P*sizeof(double));
+
+        fatoraPistas(U, L, piv, n);
+
+        if (pol) {
+            for (int i=0; i<n; ++i)
+                for (int p=0; p<P; ++p)
+                    b[P*i+p] = (p < qg) ? G[p]->B[i] : 0.0;
+            substituiPistas(U, L, piv, n, b);
+            for (int p=0; p<qg; ++p)
+                for (int i=0; i<n; ++i)
+                    pol[(size_t)g*P+p][i] = b[P*i+p];
+        }
+
+        for (int p=0; p<qg; ++p) {
+            t_sist *SL = G[p];
+            ++SL->fatoracoes;
+            if (pol) ++SL->reusos;
+            if (!guarda) continue;
+
+            if (alocaFatores(SL)) {
+                falha = 1;
+                continue;
+            }
+            for (size_t e=0; e<nn; ++e) {
+                SL->U[e] = U[P*e+p];
+                SL->L[e] = L[P*e+p];
+            }
+            // como em SL_triangulariza_otimiz(), só as etapas com troca
+            for (int i=0; i<n; ++i)
+                if (piv[P*i+p] != i) {
+                    SL->vetTroca[2*i] = i;
+                    SL->vetTroca[2*i+1] = piv[P*i+p];
+                }
+        }
+    }
+
+    SL_liberaMem(piv);
+    SL_liberaMem(U);
+  }
+
+  return falha ? -1 : 0;
+}
+
+/*!
+  \brief Fatora muitos sistemas pequenos de mesma dimensão juntos, um por
+         pista SIMD (grupos de SIMD_PISTAS intercalados elemento a elemento)
+  \note cada sistema recebe L, U e vetTroca idênticos aos de
+        SL_triangulariza_otimiz(), e SL_substituicao() os reaproveita.
+        Sistemas já fatorados são mantidos, e os com outro método ou LU
+        por blocos (metodo != SL_LU ou bk) são fatorados um a um por
+        SL_fatoracao(). Os grupos são divididos entre as threads OpenMP
+
+  \param S os sistemas
+  \param qtd número de sistemas
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_fatoracao_intercalada(t_sist **S, unsigned int qtd) {
+
+  t_sist **pend = SL_alocaMem((qtd ? qtd : 1) * sizeof(t_sist *));
+  unsigned int k = 0;
+  int ret = 0;
+
+  if (!pend) {
+      perror("Falha ao alocar sistemas intercalados");
+      return -1;
+  }
+  for (unsigned int i=0; i<qtd; ++i)
+      if (S[i]->metodo != SL_LU || S[i]->bk)
+          ret |= SL_fatoracao(S[i]);
+      else if (!(S[i]->U || S[i]->C || S[i]->QR || S[i]->LU || S[i]->LUf))
+          pend[k++] = S[i];
+
+  if (!ret && k) ret = intercalado(pend, k, NULL, 1);
+  SL_liberaMem(pend);
+  return ret ? -1 : 0;
+}
+
+/*!
+  \brief Resolve muitos sistemas pequenos de mesma dimensão juntos, um por
+         pista SIMD, sem guardar os fatores
+  \note pol[k] é idêntico ao de SL_fatoracao() e SL_substituicao() com
+        SL_LU sem blocos; S[k]->B não é alterado
+
+  \param S os sistemas, com A e B preenchidos, todos com SL_LU sem blocos
+  \param qtd número de sistemas
+  \param pol pol[k] recebe a solução de S[k] (n doubles)
+  \return 0 se sucesso e -1 em caso de falha
+*/
+int SL_resolve_intercalado(t_sist **S, unsigned int qtd, double **pol) {
+
+  for (unsigned int k=0; k<qtd; ++k)
+      if (S[k]->metodo != SL_LU || S[k]->bk) {
+          fputs("Sistemas intercalados exigem SL_LU sem blocos\n", stderr);
+          return -1;
+      }
+
+  return qtd ? intercalado(S, qtd, pol, 0) : 0;
+}
+
+/*!
+  \brief Avalia m polinômios em q pontos
+
+  \param P coeficientes, um polinômio de n termos por linha (m x n, formato
+           de saída de geraPolinomio)
+  \param t os q pontos
+  \param V valores, V[r][k] = P_r(t[k]) (m x q)
+  \return 0 se sucesso e -1 em caso de falha
+
+  \note Cada par (polinômio, bloco de SL_BK_AVALIA pontos) é uma tarefa
+        independente, dividida entre as threads OpenMP; dentro dela,
+        SIMD_horner() avalia vários pontos por vetor
+*/
+int SL_avaliaLote(const double *P, unsigned int n, unsigned int m,
+                  const double *t, unsigned int q, double *V) {
+
+  if (!m || !q) return 0;
+
+  const size_t blocos = (q + SL_BK_AVALIA - 1) / SL_BK_AVALIA;
+
+  #pragma omp parallel for schedule(static)
+  for (size_t b=0; b < (size_t)m*blocos; ++b) {
+      unsigned int r = b / blocos, k0 = (b % blocos) * SL_BK_AVALIA;
+      unsigned int qc = (q-k0 < SL_BK_AVALIA) ? q-k0 : SL_BK_AVALIA;
+
+      SIMD_horner(P + (size_t)n*r, n, t + k0, V + (size_t)q*r + k0, qc);
+  }
+
+  return 0;
+}
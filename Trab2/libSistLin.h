@@ -6,14 +6,75 @@
 #ifndef __LIBSISTLIN__
 #define __LIBSISTLIN__
 
+// tamanho padrão do bloco de SL_triangulariza_blocos()
+#define SL_BK 64
+// número de termos independentes resolvidos juntos por SL_substituicao_lote()
+#define SL_BK_LOTE 32
+// número de pontos somados juntos por SL_ajusteDeCurvas_momentos()
+#define SL_BK_MOM 8
+// número de linhas transpostas juntas por SL_ajusteDeCurvas_lote()
+#define SL_BK_GEMM 256
+// número de pontos avaliados juntos por SL_avaliaLote()
+#define SL_BK_AVALIA 1024
+// pontos (linhas) e potências (colunas) de cada ladrilho da matriz de
+// Vandermonde, montada assim por SL_interpolacao() a partir de SL_MIN_VANDER
+#define SL_BK_VANDER_LIN 16
+#define SL_BK_VANDER_COL 64
+#define SL_MIN_VANDER 256
+// matrizes a partir deste tamanho (bytes) são zeradas em paralelo por
+// SL_alocaMatrix(), para que cada página fique no nó NUMA da thread que a usa
+#define SL_PRIMEIRO_TOQUE (1 << 22)
+// máximo de iterações do refinamento iterativo de SL_LU_MISTA
+#define SL_MAX_REFINAMENTO 10
+// erro regressivo por componentes (em eps) aceito pelo refinamento
+#define SL_TOL_REFINAMENTO 4
+// alinhamento (bytes) de toda memória obtida por SL_alocaMem()
+#define SL_ALINHAMENTO 64
+
+#include <stddef.h>
+
+// fatoração utilizada por SL_fatoracao()
+typedef enum { SL_LU = 0, SL_CHOLESKY, SL_QR, SL_LU_COMPACTA, SL_LU_INDIRETA, SL_LU_MISTA } t_metodo;
+
 typedef struct {
     unsigned int n, m;
     double *A;
     double *L, *U;
     int *vetTroca;
+    double *C; // fator de Cholesky compactado (triângulo inferior por linhas)
+    double *QR, *tau; // fatoração QR de Householder de A (m x n), ver SL_qr()
+    double *LU; // L e U compactos em um único arranjo, ver SL_triangulariza_compacta()
+    int *piv;   // permutação de LU: linha i trocada com piv[i]
+    int *perm;  // SL_LU_INDIRETA: linha lógica i de LU é a linha física perm[i]
+    float *LUf; // SL_LU_MISTA: LU compacta em precisão simples, com piv
+    double *LUd; // SL_LU_MISTA: espaço da LU em double, reservado por SL_fatoracao()
+    t_metodo metodo;
+    _Bool emLugar; // SL_LU_COMPACTA sobrescreve A com os fatores
     union { double *x, *B; };
+    unsigned int bk; // tamanho do bloco da fatoração (0: sem blocos)
+    unsigned long fatoracoes, reusos; // contadores de SL_fatoracao()
+    unsigned long refinamentos; // iterações de refinamento (SL_LU_MISTA)
+    _Bool mapeado; // A e x apontam para a entrada binária mapeada (somente leitura)
+    _Bool binario; // formato da entrada (SL_leituraCabecalho())
 } t_sist;
 
+typedef struct {
+    char *base;        // bloco alinhado em SL_ALINHAMENTO bytes
+    size_t cap, usado; // capacidade e bytes já entregues desde a reinicialização
+    size_t excedente;  // bytes que não couberam e foram alocados no heap
+    size_t pico;       // maior uso (usado + excedente) já observado
+} t_arena;
+
+
+t_arena *SL_arenaCria(size_t cap);
+void SL_arenaAtiva(t_arena *arena);
+int SL_arenaPrepara(t_arena *arena, size_t tam);
+int SL_arenaReinicia(t_arena *arena);
+size_t SL_arenaMarca(void);
+void SL_arenaVolta(size_t marca);
+void SL_arenaLibera(t_arena *arena);
+void *SL_alocaMem(size_t tam);
+void SL_liberaMem(void *p);
 
 double* SL_alocaMatrix(unsigned int n, unsigned int m);
 void SL_printMatrix(FILE *f_out, double *matrix, unsigned int n, unsigned int m);
@@ -21,11 +82,36 @@ void SL_printMatrix(FILE *f_out, double *matrix, unsigned int n, unsigned int m)
 t_sist *SL_aloca(unsigned int n, unsigned int m);
 void SL_libera(t_sist *SL);
 t_sist *SL_leitura();
+t_sist *SL_leituraCabecalho();
+int SL_leituraLinhas(t_sist *SL, double *A, unsigned int qtd);
+int SL_leituraMatriz(t_sist *SL);
 
 int SL_interpolacao(t_sist *SL, t_sist *Int, unsigned int row);
+int *SL_ordemLeja(const double *x, unsigned int n);
+int SL_interpolacao_bp(t_sist *SL, const int *ordem, unsigned int row, double *pol);
 int SL_ajusteDeCurvas(t_sist *SL, t_sist *Ajc, unsigned int row, double *lookup);
+int SL_ajusteDeCurvas_momentos(t_sist *SL, t_sist *Ajc, unsigned int row);
+int SL_ajusteDeCurvas_lote(t_sist *SL, double *X);
 int SL_triangulariza(t_sist *SL);
 int SL_triangulariza_otimiz(t_sist *SL);
+int SL_triangulariza_fixa(t_sist *SL);
+int SL_triangulariza_blocos(t_sist *SL, unsigned int bk);
+int SL_triangulariza_compacta(t_sist *SL, unsigned int bk);
+int SL_triangulariza_indireta(t_sist *SL, unsigned int bk);
+int SL_triangulariza_mista(t_sist *SL, unsigned int bk);
+int SL_cholesky(t_sist *SL);
+int SL_ajusteInclui(t_sist *Ajc, double x, const double *y, double *B, unsigned int m);
+int SL_ajusteRemove(t_sist *Ajc, double x, const double *y, double *B, unsigned int m);
+int SL_qr(t_sist *SL);
+int SL_qr_lote(t_sist *SL, const double *Y, double *X, unsigned int m);
+int SL_fatoracao(t_sist *SL);
+int SL_fatoracao_intercalada(t_sist **S, unsigned int qtd);
+int SL_resolve_intercalado(t_sist **S, unsigned int qtd, double **pol);
 void SL_substituicao(t_sist *SL, double *pol);
+// com SL_LU_MISTA, pode refatorar SL em double (SL_LU_COMPACTA) no espaço
+// reservado em SL->LUd, sem alocar fatores
+int SL_substituicao_lote(t_sist *SL, double *X, unsigned int m);
+int SL_avaliaLote(const double *P, unsigned int n, unsigned int m,
+                  const double *t, unsigned int q, double *V);
 
 #endif // __LIBSISTLIN__